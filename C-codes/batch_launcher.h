@@ -0,0 +1,307 @@
+/*
+ * batch_launcher.h - start a manifest of N commands as one unit
+ *
+ * Every child is created with CREATE_SUSPENDED and assigned to one Job Object
+ * before its first instruction runs, so it (and anything it spawns) can be
+ * waited for and torn down collectively. Nothing is resumed until the whole
+ * batch is in the job: otherwise an early child could exit before the next one
+ * is assigned, and the job would report "no active processes" too soon.
+ * Without BATCH_SUSPENDED BatchLaunch() resumes the batch itself; with it the
+ * batch stays frozen until the caller calls BatchResumeAll(). The job is
+ * bound to an IO completion port, so BatchWaitAll() is a single wait for
+ * "no active processes" instead of N WaitForSingleObject calls. Windows may
+ * drop job notifications, so the wait wakes every BATCH_POLL_MS and asks the
+ * job for its active process count as well.
+ * JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE makes BatchClose() a complete teardown.
+ */
+#ifndef BATCH_LAUNCHER_H
+#define BATCH_LAUNCHER_H
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BATCH_SUSPENDED 0x1   /* leave children frozen until BatchResumeAll() */
+#define BATCH_POLL_MS 100     /* BatchWaitAll() re-checks the job this often */
+
+typedef struct {
+    PROCESS_INFORMATION pi;
+    BOOL started;
+    BOOL resumed;
+    DWORD error;          /* GetLastError() when CreateProcess or job assignment failed */
+    double createMs;      /* duration of the CreateProcess call */
+    double resumedMs;     /* batch start -> ResumeThread() returned; not the child's own start-up */
+    DWORD exitCode;       /* valid after BatchWaitAll() */
+} LaunchedChild;
+
+typedef struct {
+    HANDLE job;
+    HANDLE port;
+    LaunchedChild *children;
+    int count;
+    int started;
+    LARGE_INTEGER origin; /* batch start, for resumedMs */
+    double launchMs;      /* creating every child */
+    double resumeMs;      /* BatchResumeAll() */
+} ProcessBatch;
+
+static double BatchElapsedMs(LARGE_INTEGER from) {
+    LARGE_INTEGER now, freq;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&freq);
+    return (double)(now.QuadPart - from.QuadPart) * 1000.0 / (double)freq.QuadPart;
+}
+
+/* One command line per line; blank lines and lines starting with '#' are skipped.
+   Returns the number of commands (0 on error); free with BatchFreeManifest(). */
+static int BatchLoadManifest(const char *path, char ***commands) {
+    FILE *file = fopen(path, "r");
+    char line[1024];
+    int count = 0, capacity = 16;
+    char **list;
+
+    *commands = NULL;
+    if (file == NULL) {
+        return 0;
+    }
+    list = (char **)malloc(sizeof(char *) * (size_t)capacity);
+    while (list != NULL && fgets(line, sizeof(line), file)) {
+        size_t len = strcspn(line, "\r\n");
+        line[len] = '\0';
+        if (len == 0 || line[0] == '#') {
+            continue;
+        }
+        if (count == capacity) {
+            char **grown = (char **)realloc(list, sizeof(char *) * (size_t)(capacity *= 2));
+            if (grown == NULL) {
+                break;
+            }
+            list = grown;
+        }
+        list[count] = (char *)malloc(len + 1);
+        if (list[count] == NULL) {
+            break;
+        }
+        memcpy(list[count++], line, len + 1);
+    }
+    fclose(file);
+    *commands = list;
+    return count;
+}
+
+static void BatchFreeManifest(char **commands, int count) {
+    int i;
+    for (i = 0; i < count; ++i) {
+        free(commands[i]);
+    }
+    free(commands);
+}
+
+static void BatchResumeAll(ProcessBatch *batch);
+static void BatchClose(ProcessBatch *batch);
+
+/* Releases whatever BatchLaunch() had set up, keeping its error code */
+static BOOL BatchSetupFailed(ProcessBatch *batch) {
+    DWORD error = GetLastError();
+    BatchClose(batch);
+    SetLastError(error);
+    return FALSE;
+}
+
+/* Starts every command; returns FALSE (with GetLastError() set and nothing
+   left to close) only if the batch itself could not be set up. Children that
+   failed to start have started == FALSE. */
+static BOOL BatchLaunch(ProcessBatch *batch, const char *const *commands, int count, DWORD flags) {
+    JOBOBJECT_ASSOCIATE_COMPLETION_PORT association;
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+    char *cmdLine;
+    size_t longest = 0;
+    int i;
+
+    ZeroMemory(batch, sizeof(*batch));
+    batch->count = count;
+    batch->children = (LaunchedChild *)calloc((size_t)count, sizeof(LaunchedChild));
+    batch->job = CreateJobObjectA(NULL, NULL);
+    batch->port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    if (batch->children == NULL || batch->job == NULL || batch->port == NULL) {
+        return BatchSetupFailed(batch);
+    }
+
+    association.CompletionKey = batch->job;
+    association.CompletionPort = batch->port;
+    ZeroMemory(&limits, sizeof(limits));
+    limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+    if (!SetInformationJobObject(batch->job, JobObjectAssociateCompletionPortInformation,
+                                 &association, sizeof(association)) ||
+        !SetInformationJobObject(batch->job, JobObjectExtendedLimitInformation,
+                                 &limits, sizeof(limits))) {
+        return BatchSetupFailed(batch);
+    }
+
+    /* CreateProcess may modify the command line, so it needs a writable copy */
+    for (i = 0; i < count; ++i) {
+        size_t len = strlen(commands[i]);
+        if (len > longest) {
+            longest = len;
+        }
+    }
+    cmdLine = (char *)malloc(longest + 1);
+    if (cmdLine == NULL) {
+        return BatchSetupFailed(batch);
+    }
+
+    QueryPerformanceCounter(&batch->origin);
+    for (i = 0; i < count; ++i) {
+        LaunchedChild *child = &batch->children[i];
+        STARTUPINFOA si;
+        LARGE_INTEGER t0;
+
+        ZeroMemory(&si, sizeof(si));
+        si.cb = sizeof(si);
+        memcpy(cmdLine, commands[i], strlen(commands[i]) + 1);
+
+        QueryPerformanceCounter(&t0);
+        child->started = CreateProcessA(NULL, cmdLine, NULL, NULL, FALSE, CREATE_SUSPENDED,
+                                        NULL, NULL, &si, &child->pi);
+        child->createMs = BatchElapsedMs(t0);
+        if (!child->started) {
+            child->error = GetLastError();
+            continue;
+        }
+        if (!AssignProcessToJobObject(batch->job, child->pi.hProcess)) {
+            /* Outside the job it could be neither waited for nor torn down */
+            child->error = GetLastError();
+            TerminateProcess(child->pi.hProcess, 1);
+            CloseHandle(child->pi.hThread);
+            CloseHandle(child->pi.hProcess);
+            child->started = FALSE;
+            continue;
+        }
+        ++batch->started;
+    }
+    batch->launchMs = BatchElapsedMs(batch->origin);
+    free(cmdLine);
+    if (!(flags & BATCH_SUSPENDED)) {
+        BatchResumeAll(batch);
+    }
+    return TRUE;
+}
+
+/* Releases the suspended batch; every child starts within resumeMs */
+static void BatchResumeAll(ProcessBatch *batch) {
+    LARGE_INTEGER t0;
+    int i;
+
+    QueryPerformanceCounter(&t0);
+    for (i = 0; i < batch->count; ++i) {
+        LaunchedChild *child = &batch->children[i];
+        if (child->started && !child->resumed) {
+            ResumeThread(child->pi.hThread);
+            child->resumed = TRUE;
+            child->resumedMs = BatchElapsedMs(batch->origin);
+        }
+    }
+    batch->resumeMs = BatchElapsedMs(t0);
+}
+
+/* Processes still alive in the job, or -1 if the job cannot be queried */
+static long BatchActiveProcesses(const ProcessBatch *batch) {
+    JOBOBJECT_BASIC_ACCOUNTING_INFORMATION info;
+
+    if (!QueryInformationJobObject(batch->job, JobObjectBasicAccountingInformation,
+                                   &info, sizeof(info), NULL)) {
+        return -1;
+    }
+    return (long)info.ActiveProcesses;
+}
+
+/* Waits until every process in the job has exited, then collects exit codes.
+   Returns FALSE if timeoutMs (or INFINITE) passes first. */
+static BOOL BatchWaitAll(ProcessBatch *batch, DWORD timeoutMs) {
+    ULONGLONG start = GetTickCount64();
+    DWORD message;
+    ULONG_PTR key;
+    LPOVERLAPPED overlapped;
+    int i;
+
+    if (batch->started == 0) {
+        return TRUE;
+    }
+    for (;;) {
+        DWORD waitMs = BATCH_POLL_MS;
+        if (timeoutMs != INFINITE) {
+            ULONGLONG elapsed = GetTickCount64() - start;
+            if (elapsed >= timeoutMs) {
+                return FALSE;
+            }
+            if (timeoutMs - elapsed < waitMs) {
+                waitMs = (DWORD)(timeoutMs - elapsed);
+            }
+        }
+        if (GetQueuedCompletionStatus(batch->port, &message, &key, &overlapped, waitMs)) {
+            if (key == (ULONG_PTR)batch->job && message == JOB_OBJECT_MSG_ACTIVE_PROCESS_ZERO) {
+                break;
+            }
+            continue;
+        }
+        /* No message this round: it may have been dropped, so ask the job */
+        if (BatchActiveProcesses(batch) == 0) {
+            break;
+        }
+    }
+    for (i = 0; i < batch->count; ++i) {
+        if (batch->children[i].started) {
+            GetExitCodeProcess(batch->children[i].pi.hProcess, &batch->children[i].exitCode);
+        }
+    }
+    return TRUE;
+}
+
+/* Kills whatever is still running in the job */
+static void BatchTerminate(ProcessBatch *batch, UINT exitCode) {
+    if (batch->job != NULL) {
+        TerminateJobObject(batch->job, exitCode);
+    }
+}
+
+/* Closes every handle; closing the job also kills any survivors */
+static void BatchClose(ProcessBatch *batch) {
+    int i;
+
+    for (i = 0; batch->children != NULL && i < batch->count; ++i) {
+        if (batch->children[i].started) {
+            CloseHandle(batch->children[i].pi.hThread);
+            CloseHandle(batch->children[i].pi.hProcess);
+        }
+    }
+    free(batch->children);
+    if (batch->job != NULL) {
+        CloseHandle(batch->job);
+    }
+    if (batch->port != NULL) {
+        CloseHandle(batch->port);
+    }
+    ZeroMemory(batch, sizeof(*batch));
+}
+
+/* Per-child table: PID, create-call latency, time until resumed, exit code */
+static void BatchReport(const ProcessBatch *batch, const char *const *commands) {
+    int i;
+
+    printf("%-6s %-8s %10s %11s %10s  %s\n", "child", "PID", "create ms", "resumed ms", "exit", "command");
+    for (i = 0; i < batch->count; ++i) {
+        const LaunchedChild *child = &batch->children[i];
+        if (!child->started) {
+            printf("%-6d %-8s %10.3f %11s %10s  %s (start failed: %lu)\n",
+                   i, "-", child->createMs, "-", "-", commands[i], child->error);
+            continue;
+        }
+        printf("%-6d %-8lu %10.3f %11.3f %10lu  %s\n", i, child->pi.dwProcessId,
+               child->createMs, child->resumedMs, child->exitCode, commands[i]);
+    }
+    printf("%d of %d started; launch %.3f ms, resume %.3f ms\n",
+           batch->started, batch->count, batch->launchMs, batch->resumeMs);
+}
+
+#endif /* BATCH_LAUNCHER_H */
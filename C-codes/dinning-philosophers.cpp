@@ -6,21 +6,228 @@
 #include <random>
 #include <condition_variable>
 #include <atomic>
+#include <climits>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+#include <new>
+#include <fstream>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 using namespace std;
 using namespace std::chrono;
 
+//=============================================================================
+// ALLOCATION COUNTING HOOK (build with -DDINING_COUNT_ALLOCATIONS)
+//=============================================================================
+// Replaces global operator new with a version that counts allocations per
+// thread, so --check-allocations can prove the philosopher loops never touch
+// the heap. Without the flag allocation_count() reports -1 (not measured).
+#ifdef DINING_COUNT_ALLOCATIONS
+static thread_local long long thread_allocations = 0;
+
+// Out of line so GCC does not pair the inlined free() with a builtin new
+#if defined(__GNUC__)
+#define DINING_NOINLINE __attribute__((noinline))
+#else
+#define DINING_NOINLINE
+#endif
+
+DINING_NOINLINE void* operator new(size_t size) {
+    ++thread_allocations;
+    if (void* p = malloc(size ? size : 1)) {
+        return p;
+    }
+    throw bad_alloc();
+}
+
+DINING_NOINLINE void operator delete(void* p) noexcept { free(p); }
+#if defined(__cpp_sized_deallocation)
+DINING_NOINLINE void operator delete(void* p, size_t) noexcept { free(p); }
+#endif
+#endif
+
+inline long long allocation_count() {
+#ifdef DINING_COUNT_ALLOCATIONS
+    return thread_allocations;
+#else
+    return -1;
+#endif
+}
+
+//=============================================================================
+// FUTEX / PARKING HELPERS (block a thread on an atomic<int> word)
+//=============================================================================
+inline void cpu_relax() {
+#if defined(_MSC_VER)
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Futex::wait() sleeps only while the word still holds the expected value, so a
+// wake that races with the caller's last check is never lost. Spurious wakeups
+// are allowed: callers always re-check their condition in a loop.
+class Futex {
+public:
+#if defined(__linux__)
+    static_assert(sizeof(atomic<int>) == sizeof(int), "futex word must be a plain int");
+
+    static void wait(atomic<int>& word, int expected) {
+        syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    }
+
+    // Returns false once the deadline has passed without a wake
+    static bool wait_until(atomic<int>& word, int expected, steady_clock::time_point deadline) {
+        auto remaining = duration_cast<nanoseconds>(deadline - steady_clock::now()).count();
+        if (remaining <= 0) {
+            return false;
+        }
+        timespec timeout;
+        timeout.tv_sec = static_cast<time_t>(remaining / 1000000000);
+        timeout.tv_nsec = static_cast<long>(remaining % 1000000000);
+        long rc = syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT_PRIVATE, expected, &timeout, nullptr, 0);
+        return !(rc == -1 && errno == ETIMEDOUT);
+    }
+
+    static void wake_one(atomic<int>& word) {
+        syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+
+    static void wake_all(atomic<int>& word) {
+        syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+#else
+    // Portable fallback: a small "parking lot" of mutex/condvar buckets hashed by
+    // address. Waking notifies the whole bucket; waiters re-check their word.
+    static void wait(atomic<int>& word, int expected) {
+        Bucket& b = bucket_for(&word);
+        unique_lock<mutex> lock(b.mtx);
+        if (word.load() == expected) {
+            b.cv.wait(lock);
+        }
+    }
+
+    static bool wait_until(atomic<int>& word, int expected, steady_clock::time_point deadline) {
+        Bucket& b = bucket_for(&word);
+        unique_lock<mutex> lock(b.mtx);
+        if (word.load() == expected) {
+            return b.cv.wait_until(lock, deadline) == cv_status::no_timeout;
+        }
+        return true;
+    }
+
+    static void wake_one(atomic<int>& word) { wake_all(word); }
+
+    static void wake_all(atomic<int>& word) {
+        Bucket& b = bucket_for(&word);
+        lock_guard<mutex> lock(b.mtx);
+        b.cv.notify_all();
+    }
+
+private:
+    struct Bucket {
+        mutex mtx;
+        condition_variable cv;
+    };
+
+    static Bucket& bucket_for(const void* address) {
+        static Bucket buckets[64];
+        return buckets[(reinterpret_cast<uintptr_t>(address) >> 4) % 64];
+    }
+#endif
+};
+
 //=============================================================================
 // CUSTOM SEMAPHORE IMPLEMENTATION (for C++11/14/17 compatibility)
 //=============================================================================
+// Fast path: permits live in an atomic counter, so acquire/release/try_acquire
+// are a single CAS or fetch_add when nobody has to wait. Only a thread that
+// finds no permit (after a short spin) registers as a waiter and parks on the
+// counter with a futex; release() issues a wake only if a waiter is registered.
 class Semaphore {
+private:
+    static const int SPIN_LIMIT = 64;
+    atomic<int> count;
+    atomic<int> waiters;
+    
+public:
+    explicit Semaphore(int initial_count) : count(initial_count), waiters(0) {}
+    
+    void acquire() {
+        if (try_acquire()) {
+            return;
+        }
+        
+        // Brief spin: the holder is usually about to release
+        for (int i = 0; i < SPIN_LIMIT; ++i) {
+            cpu_relax();
+            if (count.load(memory_order_relaxed) > 0 && try_acquire()) {
+                return;
+            }
+        }
+        
+        // Slow path: announce ourselves, then sleep while the count stays at 0.
+        // waiters/count are both seq_cst so either we see the new permit or the
+        // releaser sees us waiting.
+        waiters.fetch_add(1);
+        while (!try_acquire()) {
+            if (count.load() == 0) {
+                Futex::wait(count, 0);
+            }
+        }
+        waiters.fetch_sub(1, memory_order_relaxed);
+    }
+    
+    // Threads currently parked (or about to park) in acquire()
+    int waiting() const { return waiters.load(memory_order_relaxed); }
+
+    void release() {
+        count.fetch_add(1);
+        if (waiters.load() > 0) {
+            Futex::wake_one(count);
+        }
+    }
+    
+    bool try_acquire() {
+        int c = count.load(memory_order_relaxed);
+        while (c > 0) {
+            if (count.compare_exchange_weak(c, c - 1, memory_order_acquire, memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Original mutex + condition_variable semaphore, kept as the benchmark baseline
+class CondVarSemaphore {
 private:
     mutex mtx;
     condition_variable cv;
     int count;
     
 public:
-    explicit Semaphore(int initial_count) : count(initial_count) {}
+    explicit CondVarSemaphore(int initial_count) : count(initial_count) {}
     
     void acquire() {
         unique_lock<mutex> lock(mtx);
@@ -44,428 +251,2203 @@ public:
     }
 };
 
+//=============================================================================
+// TIMED LOCK (adaptive spin -> yield -> futex park with a deadline)
+//=============================================================================
+// Three-state futex mutex: 0 = unlocked, 1 = locked, 2 = locked with sleepers.
+// A contended try_lock_until() first spins (for a budget that adapts to how
+// often spinning paid off on this lock), then yields a few times, then parks
+// on the futex until it is woken by unlock() or the deadline passes.
+class TimedLock {
+private:
+    static const int MIN_SPIN = 16;
+    static const int MAX_SPIN = 4096;
+    static const int YIELDS = 4;
+    atomic<int> state;
+    atomic<int> spin_budget;
+
+    bool try_claim() {
+        int expected = 0;
+        return state.compare_exchange_strong(expected, 1, memory_order_acquire, memory_order_relaxed);
+    }
+
+public:
+    TimedLock() : state(0), spin_budget(MIN_SPIN * 8) {}
+
+    bool try_lock() { return try_claim(); }
+
+    void lock() { try_lock_until(steady_clock::time_point::max()); }
+
+    template <class Rep, class Period>
+    bool try_lock_for(const duration<Rep, Period>& timeout) {
+        return try_lock_until(steady_clock::now() + duration_cast<steady_clock::duration>(timeout));
+    }
+
+    bool try_lock_until(steady_clock::time_point deadline) {
+        if (try_claim()) {
+            return true;
+        }
+
+        int budget = spin_budget.load(memory_order_relaxed);
+        for (int i = 0; i < budget; ++i) {
+            cpu_relax();
+            if (state.load(memory_order_relaxed) == 0 && try_claim()) {
+                spin_budget.store(min(MAX_SPIN, budget * 2), memory_order_relaxed);
+                return true;
+            }
+        }
+        spin_budget.store(max(MIN_SPIN, budget / 2), memory_order_relaxed);
+
+        for (int i = 0; i < YIELDS; ++i) {
+            this_thread::yield();
+            if (try_claim()) {
+                return true;
+            }
+        }
+
+        // Park: mark the lock contended so unlock() knows to wake us
+        while (state.exchange(2, memory_order_acquire) != 0) {
+            if (deadline != steady_clock::time_point::max() && steady_clock::now() >= deadline) {
+                return false;
+            }
+            if (deadline == steady_clock::time_point::max()) {
+                Futex::wait(state, 2);
+            } else {
+                Futex::wait_until(state, 2, deadline);
+            }
+        }
+        return true;
+    }
+
+    void unlock() {
+        if (state.exchange(0, memory_order_release) == 2) {
+            Futex::wake_one(state);
+        }
+    }
+};
+
+// min()/max() bind these by reference, so unoptimized builds need a definition
+const int TimedLock::MIN_SPIN;
+const int TimedLock::MAX_SPIN;
+
+//=============================================================================
+// PER-THREAD PRNG (PCG32: 16 bytes of state, no syscalls, no allocation)
+//=============================================================================
+// Every philosopher owns one generator on its stack. The table draws a single
+// run seed (one random_device read, or DiningConfig::seed for reproducible
+// runs) and gives each seat its own PCG stream.
+class Pcg32 {
+private:
+    uint64_t state;
+    uint64_t increment;
+
+public:
+    typedef uint32_t result_type;
+
+    Pcg32(uint64_t seed, uint64_t stream) : state(0), increment((stream << 1) | 1) {
+        (*this)();
+        state += seed;
+        (*this)();
+    }
+
+    result_type operator()() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Value in [0, bound) by multiply-shift (no division on the hot path)
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>((static_cast<uint64_t>((*this)()) * bound) >> 32);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+};
+
+//=============================================================================
+// BACKOFF POLICIES (pluggable retry delays for the timeout strategy)
+//=============================================================================
+struct BackoffContext {
+    int attempt;               // total attempts so far, including this one
+    int consecutive_failures;  // timeouts since the last successful meal
+    bool released_chopstick;   // true if we had to put the first chopstick back
+};
+
+// Returns how long to back off, in the engine's delay units (backoff_unit_us)
+class BackoffPolicy {
+public:
+    virtual ~BackoffPolicy() {}
+    virtual int delay_units(const BackoffContext& ctx, Pcg32& gen) const = 0;
+    virtual string describe() const = 0;
+
+    // Accepts "classic", "linear:STEP", "exponential:BASE-CAP" and "jitter:BASE-SPREAD"
+    static shared_ptr<const BackoffPolicy> parse(const string& text);
+};
+
+// Original behaviour: 100 * attempts after releasing a chopstick,
+// 50 + random(0..199) after failing to get the first one
+class ClassicBackoff : public BackoffPolicy {
+public:
+    int delay_units(const BackoffContext& ctx, Pcg32& gen) const override {
+        return ctx.released_chopstick ? 100 * ctx.attempt : 50 + static_cast<int>(gen.below(200));
+    }
+    string describe() const override { return "classic"; }
+};
+
+class LinearBackoff : public BackoffPolicy {
+private:
+    int step;
+public:
+    explicit LinearBackoff(int step_units) : step(step_units) {}
+    int delay_units(const BackoffContext& ctx, Pcg32&) const override {
+        return step * ctx.consecutive_failures;
+    }
+    string describe() const override { return "linear:" + to_string(step); }
+};
+
+// Capped exponential growth with "full jitter": uniform in [0, min(cap, base * 2^k)]
+class ExponentialBackoff : public BackoffPolicy {
+private:
+    int base;
+    int cap;
+public:
+    ExponentialBackoff(int base_units, int cap_units) : base(base_units), cap(cap_units) {}
+    int delay_units(const BackoffContext& ctx, Pcg32& gen) const override {
+        int shift = min(max(ctx.consecutive_failures - 1, 0), 30);
+        long long ceiling = min(static_cast<long long>(cap), static_cast<long long>(base) << shift);
+        return static_cast<int>(gen.below(static_cast<uint32_t>(ceiling + 1)));
+    }
+    string describe() const override { return "exponential:" + to_string(base) + "-" + to_string(cap); }
+};
+
+class JitteredBackoff : public BackoffPolicy {
+private:
+    int base;
+    int spread;
+public:
+    JitteredBackoff(int base_units, int spread_units) : base(base_units), spread(max(1, spread_units)) {}
+    int delay_units(const BackoffContext&, Pcg32& gen) const override {
+        return base + static_cast<int>(gen.below(static_cast<uint32_t>(spread)));
+    }
+    string describe() const override { return "jitter:" + to_string(base) + "-" + to_string(spread); }
+};
+
+shared_ptr<const BackoffPolicy> BackoffPolicy::parse(const string& text) {
+    if (text == "classic") {
+        return make_shared<ClassicBackoff>();
+    }
+    size_t colon = text.find(':');
+    if (colon == string::npos) {
+        return nullptr;
+    }
+    string kind = text.substr(0, colon);
+    string args = text.substr(colon + 1);
+    size_t dash = args.find('-');
+    int a = atoi(args.substr(0, dash).c_str());
+    int b = (dash == string::npos) ? a : atoi(args.substr(dash + 1).c_str());
+    if (a < 0 || b < 0) {
+        return nullptr;
+    }
+    if (kind == "linear") return make_shared<LinearBackoff>(a);
+    if (kind == "exponential") return make_shared<ExponentialBackoff>(max(1, a), max(a, b));
+    if (kind == "jitter") return make_shared<JitteredBackoff>(a, b);
+    return nullptr;
+}
+
+//=============================================================================
+// PER-SEAT STORAGE LAYOUT (compile-time: padded vs packed)
+//=============================================================================
+// With DINING_PADDED_LAYOUT=1 (default) every per-philosopher element -- a
+// chopstick, a priority counter, a wait slot, a statistics block -- starts on
+// its own cache line, so neighbours running on different cores never bounce
+// a shared line. Build with -DDINING_PADDED_LAYOUT=0 for the packed layout
+// (elements back to back, like the original arrays) to compare with perf c2c.
+#ifndef DINING_PADDED_LAYOUT
+#define DINING_PADDED_LAYOUT 1
+#endif
+
+// A fixed 64 rather than hardware_destructive_interference_size: GCC warns
+// (-Winterference-size) that the library value may differ between compilers
+// and flags, and 64 is right for current x86 and most ARM cores.
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Fixed-size array of per-seat elements. Allocates and aligns its own storage
+// because over-aligned operator new is C++17-only.
+template <class T>
+class PerSeat {
+private:
+#if DINING_PADDED_LAYOUT
+    struct alignas(CACHE_LINE_SIZE) Slot { T value; Slot() : value() {} explicit Slot(const T& v) : value(v) {} };
+#else
+    struct Slot { T value; Slot() : value() {} explicit Slot(const T& v) : value(v) {} };
+#endif
+
+    void* raw;
+    Slot* slots;
+    size_t count;
+
+    void allocate(size_t n) {
+        size_t space = n * sizeof(Slot) + alignof(Slot);
+        raw = ::operator new(space);
+        void* aligned = raw;
+        slots = static_cast<Slot*>(align(alignof(Slot), n * sizeof(Slot), aligned, space));
+        count = n;
+    }
+
+public:
+    explicit PerSeat(size_t n) {
+        allocate(n);
+        for (size_t i = 0; i < n; ++i) {
+            new (&slots[i]) Slot();
+        }
+    }
+
+    PerSeat(size_t n, const T& initial) {
+        allocate(n);
+        for (size_t i = 0; i < n; ++i) {
+            new (&slots[i]) Slot(initial);
+        }
+    }
+
+    ~PerSeat() {
+        for (size_t i = 0; i < count; ++i) {
+            slots[i].~Slot();
+        }
+        ::operator delete(raw);
+    }
+
+    PerSeat(const PerSeat&) = delete;
+    PerSeat& operator=(const PerSeat&) = delete;
+
+    T& operator[](size_t i) { return slots[i].value; }
+    const T& operator[](size_t i) const { return slots[i].value; }
+    size_t size() const { return count; }
+
+    static size_t stride() { return sizeof(Slot); }
+};
+
+//=============================================================================
+// EVENT LOG (per-thread lock-free rings drained by a background writer)
+//=============================================================================
+// Philosophers never touch cout. A state transition is a 24-byte binary
+// record (timestamp, philosopher, event, two arguments) pushed into the
+// calling thread's own single-producer ring; a writer thread drains all
+// rings every millisecond, orders the batch by timestamp and formats it off
+// the hot path. A full ring drops the record (counted) instead of blocking.
+// Build with -DDINING_LOGGING=0 to compile all of this out.
+#ifndef DINING_LOGGING
+#define DINING_LOGGING 1
+#endif
+
+enum class LogEvent : uint16_t {
+    THINKING_MEAL, THINKING, THINKING_ATTEMPT, THINKING_ENHANCED,
+    WANTS_PERMISSION, ASKS_WAITER, TRYING_CHOPSTICKS, TRYING_TIMEOUT, TRYING_PRIORITY,
+    PICKED_LEFT, PICKED_RIGHT, GOT_FIRST, GOT_SECOND,
+    WAITER_GRANTED, WAITER_RETURNED,
+    EATING_MEAL, EATING_ENHANCED,
+    PUT_DOWN_BOTH, FINISHED_EATING_MEAL, FINISHED_MEAL, FINISHED_PRIORITY_RESET,
+    TIMEOUT_SECOND, TIMEOUT_FIRST,
+    COMPLETED, COMPLETED_ENHANCED, FINISHED_WITH,
+    ASKS_NEIGHBOURS, FORK_RECEIVED, FORK_SENT,
+    COUNT
+};
+
+// %p = philosopher, %a / %b = the record's two arguments
+static const char* const LOG_FORMATS[static_cast<int>(LogEvent::COUNT)] = {
+    "Philosopher %p is thinking (meal %a)...",
+    "Philosopher %p is thinking...",
+    "Philosopher %p is thinking (attempt %a)...",
+    "Philosopher %p is thinking (enhanced original)...",
+    "Philosopher %p wants to eat, requesting dining permission...",
+    "Philosopher %p asks waiter for permission to eat...",
+    "Philosopher %p trying to pick up chopsticks...",
+    "Philosopher %p attempting to get chopsticks (timeout approach)...",
+    "Philosopher %p (priority %a) trying to get chopsticks...",
+    "Philosopher %p picked up left chopstick %a",
+    "Philosopher %p picked up right chopstick %a",
+    "Philosopher %p got first chopstick %a",
+    "Philosopher %p got second chopstick %a",
+    "Waiter: Granted chopsticks %a and %b to Philosopher %p",
+    "Waiter: Philosopher %p returned chopsticks %a and %b",
+    "*** Philosopher %p is EATING (meal %a) ***",
+    "*** Philosopher %p is EATING (enhanced) ***",
+    "Philosopher %p put down both chopsticks",
+    "Philosopher %p finished eating meal %a",
+    "Philosopher %p finished meal %a",
+    "Philosopher %p finished eating (priority reset)",
+    "Philosopher %p timed out on second chopstick, backing off...",
+    "Philosopher %p timed out on first chopstick, will retry...",
+    "Philosopher %p completed all meals!",
+    "Philosopher %p completed all meals! (Enhanced Original)",
+    "Philosopher %p finished with %a meals eaten!",
+    "Philosopher %p is hungry, asks neighbours for %a fork(s)...",
+    "Philosopher %p received clean fork %a",
+    "Philosopher %p hands dirty fork %a to Philosopher %b",
+};
+
+struct LogRecord {
+    uint64_t timestamp_ns;
+    int32_t philosopher;
+    LogEvent event;
+    int32_t a;
+    int32_t b;
+};
+
+class EventLog {
+private:
+    static const uint32_t RING_CAPACITY = 1024;  // power of two
+
+    struct Ring {
+        alignas(CACHE_LINE_SIZE) atomic<uint32_t> head;  // next slot the writer reads
+        alignas(CACHE_LINE_SIZE) atomic<uint32_t> tail;  // next slot the producer fills
+        uint64_t dropped;                                // producer-owned
+        LogRecord slots[RING_CAPACITY];
+
+        Ring() : head(0), tail(0), dropped(0) {}
+    };
+
+    PerSeat<Ring> rings;
+    atomic<bool> running;
+    thread writer;
+    vector<LogRecord> batch;
+    string text;
+
+    static void append_number(string& out, long long value) {
+        char digits[24];
+        int len = snprintf(digits, sizeof(digits), "%lld", value);
+        out.append(digits, static_cast<size_t>(len));
+    }
+
+    static void format(const LogRecord& r, string& out) {
+        for (const char* f = LOG_FORMATS[static_cast<int>(r.event)]; *f; ++f) {
+            if (f[0] == '%' && (f[1] == 'p' || f[1] == 'a' || f[1] == 'b')) {
+                ++f;
+                append_number(out, *f == 'p' ? r.philosopher : (*f == 'a' ? r.a : r.b));
+            } else {
+                out += *f;
+            }
+        }
+        out += '\n';
+    }
+
+    // Moves everything currently published to the console, oldest first
+    void drain() {
+        batch.clear();
+        for (size_t i = 0; i < rings.size(); ++i) {
+            Ring& ring = rings[i];
+            uint32_t head = ring.head.load(memory_order_relaxed);
+            uint32_t tail = ring.tail.load(memory_order_acquire);
+            for (; head != tail; ++head) {
+                batch.push_back(ring.slots[head & (RING_CAPACITY - 1)]);
+            }
+            ring.head.store(head, memory_order_release);
+        }
+        if (batch.empty()) {
+            return;
+        }
+        stable_sort(batch.begin(), batch.end(), [](const LogRecord& x, const LogRecord& y) {
+            return x.timestamp_ns < y.timestamp_ns;
+        });
+        text.clear();
+        for (const LogRecord& r : batch) {
+            format(r, text);
+        }
+        cout.write(text.data(), static_cast<streamsize>(text.size()));
+        cout.flush();
+    }
+
+    void writer_loop() {
+        while (running.load(memory_order_acquire)) {
+            drain();
+            this_thread::sleep_for(milliseconds(1));
+        }
+        drain();
+    }
+
+public:
+    explicit EventLog(int producers) : rings(static_cast<size_t>(producers)), running(true) {
+        batch.reserve(RING_CAPACITY);
+        writer = thread(&EventLog::writer_loop, this);
+    }
+
+    // Stops the writer after it has printed every record published so far
+    ~EventLog() {
+        running.store(false, memory_order_release);
+        writer.join();
+        uint64_t dropped = 0;
+        for (size_t i = 0; i < rings.size(); ++i) {
+            dropped += rings[i].dropped;
+        }
+        if (dropped > 0) {
+            cout << "(event log dropped " << dropped << " records: ring full)" << endl;
+        }
+    }
+
+    // Called only by the thread that owns ring `producer`
+    void record(int producer, int philosopher, LogEvent event, int a, int b) {
+        Ring& ring = rings[static_cast<size_t>(producer)];
+        uint32_t tail = ring.tail.load(memory_order_relaxed);
+        if (tail - ring.head.load(memory_order_acquire) == RING_CAPACITY) {
+            ++ring.dropped;
+            return;
+        }
+        LogRecord& slot = ring.slots[tail & (RING_CAPACITY - 1)];
+        slot.timestamp_ns = static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+        slot.philosopher = philosopher;
+        slot.event = event;
+        slot.a = a;
+        slot.b = b;
+        ring.tail.store(tail + 1, memory_order_release);
+    }
+};
+
+//=============================================================================
+// ENGINE FRAMEWORK: CONFIGURATION, WORKLOADS AND STATISTICS
+//=============================================================================
+inline int highest_bit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+// Think/eat/rest workload: sleep for a random duration, spin for a random
+// number of iterations, or do nothing at all (pure lock throughput).
+struct Workload {
+    enum Kind { NONE, SLEEP, SPIN };
+
+    Kind kind;
+    int min_amount;   // microseconds for SLEEP, cpu_relax() iterations for SPIN
+    int max_amount;
+
+    static Workload none() { Workload w = {NONE, 0, 0}; return w; }
+    static Workload sleep_ms(int lo, int hi) { Workload w = {SLEEP, lo * 1000, hi * 1000}; return w; }
+    static Workload spin(int lo, int hi) { Workload w = {SPIN, lo, hi}; return w; }
+
+    // Length of one phase: microseconds for SLEEP, iterations for SPIN
+    int draw(Pcg32& gen) const {
+        if (kind == NONE) {
+            return 0;
+        }
+        int amount = min_amount;
+        if (max_amount > min_amount) {
+            amount += static_cast<int>(gen.below(static_cast<uint32_t>(max_amount - min_amount + 1)));
+        }
+        return amount;
+    }
+
+    void perform(Pcg32& gen) const {
+        if (kind == NONE) {
+            return;
+        }
+        int amount = draw(gen);
+        if (kind == SLEEP) {
+            this_thread::sleep_for(microseconds(amount));
+        } else {
+            for (int i = 0; i < amount; ++i) {
+                cpu_relax();
+            }
+        }
+    }
+
+    // Accepts "none", "sleep:LO-HI" (milliseconds) and "spin:LO-HI" (iterations)
+    static bool parse(const string& text, Workload& out) {
+        if (text == "none") {
+            out = none();
+            return true;
+        }
+        size_t colon = text.find(':');
+        if (colon == string::npos) {
+            return false;
+        }
+        string kind = text.substr(0, colon);
+        string range = text.substr(colon + 1);
+        size_t dash = range.find('-');
+        int lo = atoi(range.substr(0, dash).c_str());
+        int hi = (dash == string::npos) ? lo : atoi(range.substr(dash + 1).c_str());
+        if (lo < 0 || hi < lo) {
+            return false;
+        }
+        if (kind == "sleep") {
+            out = sleep_ms(lo, hi);
+        } else if (kind == "spin") {
+            out = spin(lo, hi);
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+
+struct DiningConfig {
+    int num_philosophers;
+    int meals;              // meals per philosopher; 0 = dine until duration_ms has elapsed
+    int duration_ms;
+    Workload think;
+    Workload eat;
+    Workload rest;          // pause after each meal
+    int backoff_unit_us;    // length of one unit of the engines' built-in delays/timeouts
+    int max_attempts;       // timeout strategy: give up after this many attempts (0 = never)
+    int lock_timeout_units; // timeout strategy: how long to wait for each chopstick
+    shared_ptr<const BackoffPolicy> backoff;  // timeout strategy: delay between attempts
+    bool waiter_broadcast;  // waiter strategy: wake every waiter on each return (original notify_all)
+    int waiter_shards;      // waiter strategy: independent coordinators (1 = one central waiter)
+    uint64_t seed;          // run seed for the per-seat PRNGs (0 = draw one from random_device)
+    bool verbose;           // narrate every state transition on cout
+
+    static DiningConfig defaults() {
+        DiningConfig c;
+        c.num_philosophers = 5;
+        c.meals = 3;
+        c.duration_ms = 1000;
+        c.think = Workload::sleep_ms(400, 1200);
+        c.eat = Workload::sleep_ms(600, 600);
+        c.rest = Workload::none();
+        c.backoff_unit_us = 1000;
+        c.max_attempts = 10;
+        c.lock_timeout_units = 1000;
+        c.backoff = make_shared<ClassicBackoff>();
+        c.waiter_broadcast = false;
+        c.waiter_shards = 1;
+        c.seed = 0;
+        c.verbose = true;
+        return c;
+    }
+};
+
+// HDR-style log-linear histogram: 16 sub-buckets per power of two (~6% error),
+// values up to 2^44 (about 4.9 hours in ns). Fixed size, so recording never
+// allocates; each philosopher owns its own and they are merged after the run.
+class Histogram {
+private:
+    static const int SUB_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int MAX_BITS = 44;
+    static const int NUM_BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+    uint64_t counts[NUM_BUCKETS];
+    uint64_t total;
+    uint64_t sum;
+    uint64_t max_value;
+
+    static int index_of(uint64_t value) {
+        if (value < static_cast<uint64_t>(SUB_BUCKETS)) {
+            return static_cast<int>(value);
+        }
+        int shift = highest_bit(value) - SUB_BITS;
+        int index = (shift + 1) * SUB_BUCKETS + static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+        return std::min(index, NUM_BUCKETS - 1);
+    }
+
+    static uint64_t value_of(int index) {
+        if (index < SUB_BUCKETS) {
+            return static_cast<uint64_t>(index);
+        }
+        int shift = index / SUB_BUCKETS - 1;
+        uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+        return lower + ((uint64_t(1) << shift) >> 1);  // bucket midpoint
+    }
+
+public:
+    Histogram() { reset(); }
+
+    void reset() {
+        fill(counts, counts + NUM_BUCKETS, uint64_t(0));
+        total = 0;
+        sum = 0;
+        max_value = 0;
+    }
+
+    void record(uint64_t value) {
+        ++counts[index_of(value)];
+        ++total;
+        sum += value;
+        max_value = std::max(max_value, value);
+    }
+
+    void merge(const Histogram& other) {
+        for (int i = 0; i < NUM_BUCKETS; ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sum += other.sum;
+        max_value = std::max(max_value, other.max_value);
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return max_value; }
+    double mean() const { return total > 0 ? static_cast<double>(sum) / total : 0; }
+
+    uint64_t percentile(double p) const {
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::min(value_of(i), max_value);
+            }
+        }
+        return max_value;
+    }
+};
+
+// Histogram reduced to the numbers we report, divided by `scale`
+// (1000 turns nanoseconds into microseconds)
+struct HistogramSummary {
+    uint64_t count;
+    double mean;
+    double p50;
+    double p99;
+    double max;
+
+    static HistogramSummary of(const Histogram& h, double scale) {
+        HistogramSummary s;
+        s.count = h.count();
+        s.mean = h.mean() / scale;
+        s.p50 = h.percentile(50) / scale;
+        s.p99 = h.percentile(99) / scale;
+        s.max = h.max() / scale;
+        return s;
+    }
+};
+
+struct PhilosopherStats {
+    long long meals;
+    long long lock_failures;       // acquisitions that could not succeed immediately (or timed out)
+    long long allocations;         // heap allocations inside philosopher() (-1 = not counted)
+    Histogram think_ns;
+    Histogram wait_ns;             // hungry -> holding both chopsticks
+    Histogram eat_ns;
+    Histogram queue_depth;         // semaphore waiters seen when asking to dine
+
+    PhilosopherStats() : meals(0), lock_failures(0), allocations(-1) {}
+};
+
+struct SeatSummary {
+    long long meals;
+    long long lock_failures;
+    HistogramSummary think_us;
+    HistogramSummary wait_us;
+    HistogramSummary eat_us;
+};
+
+struct DiningResult {
+    string strategy;
+    int philosophers;
+    int cores;              // cores the run was restricted to (0 = not restricted)
+    double seconds;
+    long long total_meals;
+    long long min_meals;
+    long long max_meals;
+    double meals_per_sec;
+    double fairness;        // Jain's index over meals per philosopher (1.0 = perfectly fair)
+    double wakeups_per_meal;  // waiter strategies only, -1 elsewhere
+    long long allocations;    // heap allocations in all philosopher loops (-1 = not counted)
+    long long lock_failures;
+    HistogramSummary think_us;
+    HistogramSummary wait_us;
+    HistogramSummary eat_us;
+    HistogramSummary queue_depth;
+    vector<SeatSummary> seats;
+};
+
+// Instrumentation output: a console summary after each demo and JSON / CSV
+// export of one or more runs for offline analysis
+class DiningReport {
+private:
+    static void json_summary(ostream& out, const char* key, const HistogramSummary& h) {
+        out << "\"" << key << "\": {\"count\": " << h.count << ", \"mean\": " << h.mean
+            << ", \"p50\": " << h.p50 << ", \"p99\": " << h.p99 << ", \"max\": " << h.max << "}";
+    }
+
+    static void print_line(const char* label, const HistogramSummary& h, const char* unit) {
+        cout << "  " << left << setw(12) << label << right << fixed << setprecision(1)
+             << "mean " << setw(10) << h.mean << "  p50 " << setw(10) << h.p50
+             << "  p99 " << setw(10) << h.p99 << "  max " << setw(10) << h.max
+             << " " << unit << "  (" << h.count << " samples)" << endl;
+    }
+
+public:
+    static void print(const DiningResult& r) {
+        cout << "\nInstrumentation (" << r.strategy << ", " << r.philosophers << " philosophers, "
+             << fixed << setprecision(2) << r.seconds << " s):" << endl;
+        print_line("think", r.think_us, "us");
+        print_line("wait", r.wait_us, "us");
+        print_line("eat", r.eat_us, "us");
+        if (r.queue_depth.count > 0) {
+            print_line("queue depth", r.queue_depth, "waiters");
+        }
+        cout << "  lock failures: " << r.lock_failures
+             << ", fairness: " << setprecision(3) << r.fairness << endl;
+        for (size_t i = 0; i < r.seats.size(); ++i) {
+            const SeatSummary& seat = r.seats[i];
+            cout << "  Philosopher " << i << ": " << seat.meals << " meals, "
+                 << seat.lock_failures << " lock failures, wait p99 "
+                 << setprecision(1) << seat.wait_us.p99 << " us" << endl;
+        }
+    }
+
+    static bool write_json(const string& path, const vector<DiningResult>& results) {
+        ofstream out(path.c_str());
+        if (!out) {
+            return false;
+        }
+        out << fixed << setprecision(3) << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const DiningResult& r = results[i];
+            out << "  {\"strategy\": \"" << r.strategy << "\", \"philosophers\": " << r.philosophers
+                << ", \"cores\": " << r.cores << ", \"seconds\": " << r.seconds
+                << ", \"total_meals\": " << r.total_meals << ", \"meals_per_sec\": " << r.meals_per_sec
+                << ", \"fairness\": " << r.fairness << ", \"lock_failures\": " << r.lock_failures
+                << ", \"wakeups_per_meal\": " << r.wakeups_per_meal << ",\n   ";
+            json_summary(out, "think_us", r.think_us);
+            out << ",\n   ";
+            json_summary(out, "wait_us", r.wait_us);
+            out << ",\n   ";
+            json_summary(out, "eat_us", r.eat_us);
+            out << ",\n   ";
+            json_summary(out, "queue_depth", r.queue_depth);
+            out << ",\n   \"seats\": [";
+            for (size_t k = 0; k < r.seats.size(); ++k) {
+                const SeatSummary& seat = r.seats[k];
+                out << (k ? ",\n     " : "\n     ") << "{\"philosopher\": " << k
+                    << ", \"meals\": " << seat.meals << ", \"lock_failures\": " << seat.lock_failures << ", ";
+                json_summary(out, "think_us", seat.think_us);
+                out << ", ";
+                json_summary(out, "wait_us", seat.wait_us);
+                out << ", ";
+                json_summary(out, "eat_us", seat.eat_us);
+                out << "}";
+            }
+            out << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+        return static_cast<bool>(out);
+    }
+
+    // One row per philosopher per run, so starvation shows up as an outlier row
+    static bool write_csv(const string& path, const vector<DiningResult>& results) {
+        ofstream out(path.c_str());
+        if (!out) {
+            return false;
+        }
+        out << "strategy,cores,philosophers,philosopher,meals,lock_failures,"
+            << "think_p50_us,think_p99_us,think_max_us,wait_p50_us,wait_p99_us,wait_max_us,"
+            << "eat_p50_us,eat_p99_us,eat_max_us\n";
+        out << fixed << setprecision(3);
+        for (const DiningResult& r : results) {
+            for (size_t k = 0; k < r.seats.size(); ++k) {
+                const SeatSummary& seat = r.seats[k];
+                out << r.strategy << "," << r.cores << "," << r.philosophers << "," << k << ","
+                    << seat.meals << "," << seat.lock_failures << ","
+                    << seat.think_us.p50 << "," << seat.think_us.p99 << "," << seat.think_us.max << ","
+                    << seat.wait_us.p50 << "," << seat.wait_us.p99 << "," << seat.wait_us.max << ","
+                    << seat.eat_us.p50 << "," << seat.eat_us.p99 << "," << seat.eat_us.max << "\n";
+            }
+        }
+        return static_cast<bool>(out);
+    }
+
+    // Writes whichever exports were requested; an empty path means "not requested"
+    static bool export_results(const string& json_path, const string& csv_path,
+                               const vector<DiningResult>& results) {
+        bool ok = true;
+        if (!json_path.empty() && !write_json(json_path, results)) {
+            cerr << "cannot write " << json_path << endl;
+            ok = false;
+        }
+        if (!csv_path.empty() && !write_csv(csv_path, results)) {
+            cerr << "cannot write " << csv_path << endl;
+            ok = false;
+        }
+        return ok;
+    }
+};
+
+// Common driver for every strategy: owns the configuration and per-seat
+// statistics, starts one thread per philosopher and summarizes the run.
+class DiningTable {
+public:
+    explicit DiningTable(const DiningConfig& cfg)
+        : config(cfg), n(cfg.num_philosophers), stats(cfg.num_philosophers),
+          run_seed(cfg.seed != 0 ? cfg.seed : draw_seed()),
+          started(false), stop_requested(false) {}
+
+    virtual ~DiningTable() {}
+
+    virtual const char* name() const = 0;
+
+    DiningResult run() {
+#if DINING_LOGGING
+        if (config.verbose) {
+            event_log.reset(new EventLog(n));
+        }
+#endif
+        vector<thread> philosophers;
+        philosophers.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            philosophers.emplace_back(&DiningTable::seat, this, i);
+        }
+
+        // Release everyone at once so thread start-up is not measured
+        auto start = steady_clock::now();
+        {
+            lock_guard<mutex> lock(start_mutex);
+            started = true;
+        }
+        start_cv.notify_all();
+
+        if (config.meals == 0) {
+            this_thread::sleep_for(milliseconds(config.duration_ms));
+            stop_requested = true;
+        }
+
+        for (auto& t : philosophers) {
+            t.join();
+        }
+#if DINING_LOGGING
+        event_log.reset();  // prints whatever is still buffered
+#endif
+        DiningResult r = summarize(duration<double>(steady_clock::now() - start).count());
+        annotate(r);
+        return r;
+    }
+
+protected:
+    DiningConfig config;
+    const int n;
+    PerSeat<PhilosopherStats> stats;
+
+    virtual void philosopher(int id) = 0;
+
+    // Strategy-specific counters for the summary (called after all threads joined)
+    virtual void annotate(DiningResult& r) const { (void)r; }
+
+    Pcg32 rng_for(int id) const { return Pcg32(run_seed, static_cast<uint64_t>(id)); }
+
+    int left_of(int id) const { return id; }
+    int right_of(int id) const { return (id + 1) % n; }
+
+    bool keep_dining(long long meals_eaten) const {
+        if (config.meals > 0) {
+            return meals_eaten < config.meals;
+        }
+        return !stop_requested.load(memory_order_relaxed);
+    }
+
+    // Sleep for a number of the engine's built-in delay units (historically ms)
+    void backoff(int units) const {
+        if (units > 0) {
+            this_thread::sleep_for(microseconds(static_cast<long long>(units) * config.backoff_unit_us));
+        }
+    }
+
+    static uint64_t elapsed_ns(steady_clock::time_point from, steady_clock::time_point to) {
+        return static_cast<uint64_t>(duration_cast<nanoseconds>(to - from).count());
+    }
+
+    // Timed workload phases: each seat records into its own histograms
+    void think(int id, Pcg32& gen) {
+        auto start = steady_clock::now();
+        config.think.perform(gen);
+        stats[id].think_ns.record(elapsed_ns(start, steady_clock::now()));
+    }
+
+    void eat(int id, Pcg32& gen) {
+        auto start = steady_clock::now();
+        config.eat.perform(gen);
+        stats[id].eat_ns.record(elapsed_ns(start, steady_clock::now()));
+    }
+
+    void record_meal(int id, steady_clock::time_point hungry_since, steady_clock::time_point acquired) {
+        stats[id].meals++;
+        stats[id].wait_ns.record(elapsed_ns(hungry_since, acquired));
+    }
+
+    void record_lock_failure(int id) { stats[id].lock_failures++; }
+
+    void record_queue_depth(int id, int depth) { stats[id].queue_depth.record(static_cast<uint64_t>(max(depth, 0))); }
+
+    // Blocking lock that counts a failure whenever the lock was already held
+    template <class Lock>
+    void lock_counted(int id, Lock& lock) {
+        if (!lock.try_lock()) {
+            record_lock_failure(id);
+            lock.lock();
+        }
+    }
+
+    // Narration for the classroom demos (benchmarks run with verbose = false).
+    // `ring` is the calling philosopher's thread; `philosopher` the subject.
+    void log_event_as(int ring, int philosopher, LogEvent event, int a = 0, int b = 0) {
+#if DINING_LOGGING
+        if (event_log) {
+            event_log->record(ring, philosopher, event, a, b);
+        }
+#else
+        (void)ring; (void)philosopher; (void)event; (void)a; (void)b;
+#endif
+    }
+
+    void log_event(int id, LogEvent event, int a = 0, int b = 0) { log_event_as(id, id, event, a, b); }
+
+private:
+    const uint64_t run_seed;
+#if DINING_LOGGING
+    unique_ptr<EventLog> event_log;
+#endif
+    mutex start_mutex;
+    condition_variable start_cv;
+    bool started;
+    atomic<bool> stop_requested;
+
+    static uint64_t draw_seed() {
+        random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    void seat(int id) {
+        {
+            unique_lock<mutex> lock(start_mutex);
+            start_cv.wait(lock, [this] { return started; });
+        }
+        long long before = allocation_count();
+        philosopher(id);
+        stats[id].allocations = before < 0 ? -1 : allocation_count() - before;
+    }
+
+    DiningResult summarize(double seconds) const {
+        DiningResult r;
+        r.strategy = name();
+        r.philosophers = n;
+        r.cores = 0;
+        r.seconds = seconds;
+        r.total_meals = 0;
+        r.min_meals = n > 0 ? stats[0].meals : 0;
+        r.max_meals = 0;
+        r.wakeups_per_meal = -1;
+        r.allocations = 0;
+        r.lock_failures = 0;
+        r.seats.reserve(n);
+
+        Histogram think_all, wait_all, eat_all, depth_all;
+        double sum_squares = 0;
+        for (int i = 0; i < n; ++i) {
+            const PhilosopherStats& st = stats[i];
+            long long m = st.meals;
+            r.total_meals += m;
+            r.min_meals = min(r.min_meals, m);
+            r.max_meals = max(r.max_meals, m);
+            sum_squares += static_cast<double>(m) * m;
+            r.lock_failures += st.lock_failures;
+            r.allocations = (r.allocations < 0 || st.allocations < 0) ? -1 : r.allocations + st.allocations;
+            think_all.merge(st.think_ns);
+            wait_all.merge(st.wait_ns);
+            eat_all.merge(st.eat_ns);
+            depth_all.merge(st.queue_depth);
+
+            SeatSummary seat;
+            seat.meals = m;
+            seat.lock_failures = st.lock_failures;
+            seat.think_us = HistogramSummary::of(st.think_ns, 1000.0);
+            seat.wait_us = HistogramSummary::of(st.wait_ns, 1000.0);
+            seat.eat_us = HistogramSummary::of(st.eat_ns, 1000.0);
+            r.seats.push_back(seat);
+        }
+
+        r.meals_per_sec = seconds > 0 ? r.total_meals / seconds : 0;
+        r.fairness = sum_squares > 0
+            ? static_cast<double>(r.total_meals) * r.total_meals / (n * sum_squares)
+            : 0;
+        r.think_us = HistogramSummary::of(think_all, 1000.0);
+        r.wait_us = HistogramSummary::of(wait_all, 1000.0);
+        r.eat_us = HistogramSummary::of(eat_all, 1000.0);
+        r.queue_depth = HistogramSummary::of(depth_all, 1.0);
+        return r;
+    }
+};
+
 //=============================================================================
 // SOLUTION 1: SEMAPHORE-BASED APPROACH (Prevents Deadlock + Reduces Starvation)
 //=============================================================================
-class DiningPhilosophersSemaphore {
+class DiningPhilosophersSemaphore : public DiningTable {
 private:
-    static const int NUM_PHILOSOPHERS = 5;
-    static mutex chopsticks[NUM_PHILOSOPHERS];
+    PerSeat<mutex> chopsticks;
     // Key insight: Allow only N-1 philosophers to compete for chopsticks simultaneously
     // This guarantees at least one philosopher can always get both chopsticks
-    static Semaphore dining_semaphore;
-    
-    static void philosopher(int id) {
-        random_device rd;
-        mt19937 gen(rd());
-        uniform_int_distribution<> think_time(500, 1500);
-        
-        for (int meal = 0; meal < 3; ++meal) {
+    Semaphore dining_semaphore;
+
+    void philosopher(int id) override {
+        Pcg32 gen = rng_for(id);
+
+        for (long long meal = 0; keep_dining(meal); ++meal) {
             // THINKING PHASE
-            cout << "Philosopher " << id << " is thinking (meal " << meal + 1 << ")..." << endl;
-            this_thread::sleep_for(milliseconds(think_time(gen)));
-            
+            log_event(id, LogEvent::THINKING_MEAL, static_cast<int>(meal + 1));
+            think(id, gen);
+
             // ACQUIRE PERMISSION TO DINE
             // This is the key: only N-1 philosophers can attempt to eat simultaneously
             // This prevents circular wait and guarantees deadlock freedom
-            cout << "Philosopher " << id << " wants to eat, requesting dining permission..." << endl;
+            log_event(id, LogEvent::WANTS_PERMISSION);
+            auto hungry_since = steady_clock::now();
+            record_queue_depth(id, dining_semaphore.waiting());
             dining_semaphore.acquire();
-            
+
             // ACQUIRE CHOPSTICKS
-            int left_chopstick = id;
-            int right_chopstick = (id + 1) % NUM_PHILOSOPHERS;
-            
-            cout << "Philosopher " << id << " trying to pick up chopsticks..." << endl;
-            
+            int left_chopstick = left_of(id);
+            int right_chopstick = right_of(id);
+
+            log_event(id, LogEvent::TRYING_CHOPSTICKS);
+
             // Pick up chopsticks (can use any order since we're protected by semaphore)
-            chopsticks[left_chopstick].lock();
-            cout << "Philosopher " << id << " picked up left chopstick " << left_chopstick << endl;
-            
-            chopsticks[right_chopstick].lock();
-            cout << "Philosopher " << id << " picked up right chopstick " << right_chopstick << endl;
-            
+            lock_counted(id, chopsticks[left_chopstick]);
+            log_event(id, LogEvent::PICKED_LEFT, left_chopstick);
+
+            lock_counted(id, chopsticks[right_chopstick]);
+            log_event(id, LogEvent::PICKED_RIGHT, right_chopstick);
+            record_meal(id, hungry_since, steady_clock::now());
+
             // EATING PHASE
-            cout << "*** Philosopher " << id << " is EATING (meal " << meal + 1 << ") ***" << endl;
-            this_thread::sleep_for(milliseconds(800 + (id * 50))); // Slight variation in eating time
-            
+            log_event(id, LogEvent::EATING_MEAL, static_cast<int>(meal + 1));
+            eat(id, gen);
+
             // RELEASE CHOPSTICKS
             chopsticks[right_chopstick].unlock();
             chopsticks[left_chopstick].unlock();
-            cout << "Philosopher " << id << " put down both chopsticks" << endl;
-            
+            log_event(id, LogEvent::PUT_DOWN_BOTH);
+
             // RELEASE DINING PERMISSION
             dining_semaphore.release();
-            cout << "Philosopher " << id << " finished eating meal " << meal + 1 << endl;
-            
+            log_event(id, LogEvent::FINISHED_EATING_MEAL, static_cast<int>(meal + 1));
+
             // Small break between meals
-            this_thread::sleep_for(milliseconds(200));
+            config.rest.perform(gen);
         }
-        cout << "Philosopher " << id << " completed all meals!" << endl;
+        log_event(id, LogEvent::COMPLETED);
     }
-    
+
 public:
-    static void demonstrate() {
+    explicit DiningPhilosophersSemaphore(const DiningConfig& cfg)
+        : DiningTable(cfg), chopsticks(cfg.num_philosophers), dining_semaphore(cfg.num_philosophers - 1) {}
+
+    const char* name() const override { return "semaphore"; }
+
+    static DiningConfig demo_config() {
+        DiningConfig c = DiningConfig::defaults();
+        c.think = Workload::sleep_ms(500, 1500);
+        c.eat = Workload::sleep_ms(800, 1000);  // Slight variation in eating time
+        c.rest = Workload::sleep_ms(200, 200);
+        return c;
+    }
+
+    static DiningResult demonstrate() {
+        DiningConfig c = demo_config();
         cout << "\n=== SEMAPHORE-BASED DINING PHILOSOPHERS ===" << endl;
-        cout << "Solution: Allow max " << NUM_PHILOSOPHERS-1 << " philosophers to compete for chopsticks" << endl;
+        cout << "Solution: Allow max " << c.num_philosophers - 1 << " philosophers to compete for chopsticks" << endl;
         cout << "Benefits: Prevents deadlock, reduces starvation risk\n" << endl;
-        
-        vector<thread> philosophers;
-        
-        for (int i = 0; i < NUM_PHILOSOPHERS; ++i) {
-            philosophers.emplace_back(philosopher, i);
-        }
-        
-        for (auto& t : philosophers) {
-            t.join();
-        }
-        
+
+        DiningPhilosophersSemaphore table(c);
+        DiningResult r = table.run();
+
         cout << "\nAll philosophers finished dining! (Semaphore solution)" << endl;
+        DiningReport::print(r);
+        return r;
     }
 };
 
-// Static member definitions
-mutex DiningPhilosophersSemaphore::chopsticks[DiningPhilosophersSemaphore::NUM_PHILOSOPHERS];
-Semaphore DiningPhilosophersSemaphore::dining_semaphore(DiningPhilosophersSemaphore::NUM_PHILOSOPHERS-1);
-
 //=============================================================================
 // SOLUTION 2: WAITER SOLUTION (Central Coordinator - Prevents Both Issues)
 //=============================================================================
-class DiningPhilosophersWaiter {
+class DiningPhilosophersWaiter : public DiningTable {
 private:
-    static const int NUM_PHILOSOPHERS = 5;
-    static mutex chopsticks[NUM_PHILOSOPHERS];
-    static mutex waiter_mutex;  // Waiter controls access to chopstick acquisition
-    static condition_variable waiter_cv;
-    static bool chopstick_available[NUM_PHILOSOPHERS];
-    
+    // Per-philosopher wait slot: a hungry philosopher sleeps on its own condition
+    // variable until the waiter hands it both chopsticks. Guarded by the mutex
+    // of the shard that owns the seat.
+    struct WaiterSeat {
+        condition_variable cv;
+        uint64_t ticket;    // when this philosopher became hungry, in ns (0 = not hungry)
+        bool granted;
+        long long wakeups;  // times this philosopher was woken while waiting
+
+        WaiterSeat() : ticket(0), granted(false), wakeups(0) {}
+    };
+
+    // The table is split into contiguous segments, each with its own waiter
+    // (coordinator mutex). Seat i and chopstick i belong to shard_of(i); only
+    // philosophers at a segment boundary need two coordinators at once.
+    PerSeat<mutex> shard_mutex;  // shard_mutex[0] is the single waiter when unsharded
+    condition_variable waiter_cv;  // broadcast mode only
+    PerSeat<char> chopstick_available;  // not bits: shards write neighbouring entries concurrently
+    PerSeat<WaiterSeat> seats;
+
+    // Locks every shard that owns an index in [from, to] (mod n), always in
+    // ascending shard order so overlapping windows cannot deadlock.
+    class ShardGuard {
+    private:
+        static const int MAX_SHARDS = 5;
+        unique_lock<mutex> locks[MAX_SHARDS];
+        int shard_ids[MAX_SHARDS];
+        int count;
+
+    public:
+        ShardGuard(DiningPhilosophersWaiter& waiter, int from, int to) : count(0) {
+            for (int i = from; i <= to; ++i) {
+                int shard = waiter.shard_of((i % waiter.n + waiter.n) % waiter.n);
+                if (find(shard_ids, shard_ids + count, shard) == shard_ids + count) {
+                    shard_ids[count++] = shard;
+                }
+            }
+            sort(shard_ids, shard_ids + count);
+            for (int k = 0; k < count; ++k) {
+                locks[k] = unique_lock<mutex>(waiter.shard_mutex[shard_ids[k]]);
+            }
+        }
+
+        // Keep only the given shard locked and hand its lock out for waiting
+        unique_lock<mutex>& keep_only(int shard) {
+            int kept = 0;
+            for (int k = 0; k < count; ++k) {
+                if (shard_ids[k] == shard) {
+                    kept = k;
+                } else {
+                    locks[k].unlock();
+                }
+            }
+            return locks[kept];
+        }
+    };
+
+    int shard_of(int index) const {
+        return static_cast<int>(static_cast<long long>(index) * static_cast<int>(shard_mutex.size()) / n);
+    }
+
+    // Each shard must span at least 3 seats so a release window (5 seats)
+    // touches at most 3 coordinators
+    static int effective_shards(const DiningConfig& cfg) {
+        if (cfg.waiter_broadcast) {
+            return 1;
+        }
+        return max(1, min(cfg.waiter_shards, cfg.num_philosophers / 3));
+    }
+
     // Check if philosopher can pick up both chopsticks
-    static bool can_eat(int philosopher_id) {
-        int left = philosopher_id;
-        int right = (philosopher_id + 1) % NUM_PHILOSOPHERS;
-        return chopstick_available[left] && chopstick_available[right];
+    bool can_eat(int philosopher_id) const {
+        return chopstick_available[left_of(philosopher_id)] && chopstick_available[right_of(philosopher_id)];
     }
-    
+
+    int left_neighbour(int philosopher_id) const { return (philosopher_id + n - 1) % n; }
+    int right_neighbour(int philosopher_id) const { return (philosopher_id + 1) % n; }
+
+    // Tickets are timestamps so shards need no shared counter; ties go to the lower id
+    bool hungry_before(int neighbour, int philosopher_id) const {
+        uint64_t mine = seats[philosopher_id].ticket;
+        uint64_t theirs = seats[neighbour].ticket;
+        return theirs != 0 && (theirs < mine || (theirs == mine && neighbour < philosopher_id));
+    }
+
+    // FIFO rule: never overtake a neighbour who has been hungry for longer and
+    // wants one of our chopsticks
+    bool may_eat(int philosopher_id) const {
+        return seats[philosopher_id].ticket != 0 && can_eat(philosopher_id)
+            && !hungry_before(left_neighbour(philosopher_id), philosopher_id)
+            && !hungry_before(right_neighbour(philosopher_id), philosopher_id);
+    }
+
+    // `caller` is the philosopher whose thread is acting as the waiter
+    void reserve(int philosopher_id, int caller) {
+        int left = left_of(philosopher_id);
+        int right = right_of(philosopher_id);
+        chopstick_available[left] = 0;
+        chopstick_available[right] = 0;
+        seats[philosopher_id].ticket = 0;
+        log_event_as(caller, philosopher_id, LogEvent::WAITER_GRANTED, left, right);
+    }
+
     // Waiter grants permission to eat (atomic check and reserve)
-    static void request_chopsticks(int philosopher_id) {
-        unique_lock<mutex> lock(waiter_mutex);
-        
-        // Wait until both chopsticks are available
-        waiter_cv.wait(lock, [philosopher_id] { return can_eat(philosopher_id); });
-        
-        // Reserve both chopsticks atomically
-        int left = philosopher_id;
-        int right = (philosopher_id + 1) % NUM_PHILOSOPHERS;
-        chopstick_available[left] = false;
-        chopstick_available[right] = false;
-        
-        cout << "Waiter: Granted chopsticks " << left << " and " << right 
-             << " to Philosopher " << philosopher_id << endl;
+    void request_chopsticks(int philosopher_id) {
+        WaiterSeat& seat = seats[philosopher_id];
+
+        if (config.waiter_broadcast) {
+            unique_lock<mutex> lock(shard_mutex[0]);
+            // Wait until both chopsticks are available
+            if (!can_eat(philosopher_id)) {
+                record_lock_failure(philosopher_id);
+            }
+            while (!can_eat(philosopher_id)) {
+                waiter_cv.wait(lock);
+                ++seat.wakeups;
+            }
+            // Reserve both chopsticks atomically
+            reserve(philosopher_id, philosopher_id);
+            return;
+        }
+
+        // Our eligibility depends on both neighbours' seats and our two chopsticks
+        ShardGuard guard(*this, philosopher_id - 1, philosopher_id + 1);
+        seat.ticket = static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+        if (may_eat(philosopher_id)) {
+            reserve(philosopher_id, philosopher_id);
+            return;
+        }
+        record_lock_failure(philosopher_id);
+
+        // The neighbour that frees our chopsticks reserves them for us; it holds
+        // our shard's lock when it sets `granted`, so we wait on that lock alone
+        unique_lock<mutex>& lock = guard.keep_only(shard_of(philosopher_id));
+        while (!seat.granted) {
+            seat.cv.wait(lock);
+            ++seat.wakeups;
+        }
+        seat.granted = false;
     }
-    
+
+    // Hand the chopsticks to a waiting neighbour if it is now its turn
+    bool grant_if_ready(int philosopher_id, int caller) {
+        if (!may_eat(philosopher_id)) {
+            return false;
+        }
+        reserve(philosopher_id, caller);
+        seats[philosopher_id].granted = true;
+        seats[philosopher_id].cv.notify_one();
+        return true;
+    }
+
     // Waiter handles chopstick return
-    static void return_chopsticks(int philosopher_id) {
-        unique_lock<mutex> lock(waiter_mutex);
-        
-        int left = philosopher_id;
-        int right = (philosopher_id + 1) % NUM_PHILOSOPHERS;
-        chopstick_available[left] = true;
-        chopstick_available[right] = true;
-        
-        cout << "Waiter: Philosopher " << philosopher_id 
-             << " returned chopsticks " << left << " and " << right << endl;
-        
-        // Notify all waiting philosophers that chopsticks are available
-        waiter_cv.notify_all();
+    void return_chopsticks(int philosopher_id) {
+        int left = left_of(philosopher_id);
+        int right = right_of(philosopher_id);
+
+        if (config.waiter_broadcast) {
+            unique_lock<mutex> lock(shard_mutex[0]);
+            chopstick_available[left] = 1;
+            chopstick_available[right] = 1;
+            log_event(philosopher_id, LogEvent::WAITER_RETURNED, left, right);
+
+            // Notify all waiting philosophers that chopsticks are available
+            waiter_cv.notify_all();
+            return;
+        }
+
+        // Granting a neighbour reads that neighbour's other neighbour as well
+        ShardGuard guard(*this, philosopher_id - 2, philosopher_id + 2);
+        chopstick_available[left] = 1;
+        chopstick_available[right] = 1;
+
+        log_event(philosopher_id, LogEvent::WAITER_RETURNED, left, right);
+
+        // Only the two neighbours can use what was just returned; serve the one
+        // that has been hungry longer first (they share a chopstick when n == 3)
+        int first = left_neighbour(philosopher_id);
+        int second = right_neighbour(philosopher_id);
+        if (second != first && seats[second].ticket != 0
+            && (seats[first].ticket == 0 || hungry_before(second, first))) {
+            swap(first, second);
+        }
+        grant_if_ready(first, philosopher_id);
+        if (second != first) {
+            grant_if_ready(second, philosopher_id);
+        }
     }
-    
-    static void philosopher(int id) {
-        random_device rd;
-        mt19937 gen(rd());
-        uniform_int_distribution<> think_time(400, 1200);
-        
-        for (int meal = 0; meal < 3; ++meal) {
+
+    void philosopher(int id) override {
+        Pcg32 gen = rng_for(id);
+
+        for (long long meal = 0; keep_dining(meal); ++meal) {
             // THINKING
-            cout << "Philosopher " << id << " is thinking..." << endl;
-            this_thread::sleep_for(milliseconds(think_time(gen)));
-            
+            log_event(id, LogEvent::THINKING);
+            think(id, gen);
+
             // REQUEST PERMISSION FROM WAITER
-            cout << "Philosopher " << id << " asks waiter for permission to eat..." << endl;
+            log_event(id, LogEvent::ASKS_WAITER);
+            auto hungry_since = steady_clock::now();
             request_chopsticks(id);
-            
+            record_meal(id, hungry_since, steady_clock::now());
+
             // EATING (chopsticks guaranteed to be available)
-            cout << "*** Philosopher " << id << " is EATING (meal " << meal + 1 << ") ***" << endl;
-            this_thread::sleep_for(milliseconds(600));
-            
+            log_event(id, LogEvent::EATING_MEAL, static_cast<int>(meal + 1));
+            eat(id, gen);
+
             // RETURN CHOPSTICKS TO WAITER
             return_chopsticks(id);
-            cout << "Philosopher " << id << " finished meal " << meal + 1 << endl;
+            log_event(id, LogEvent::FINISHED_MEAL, static_cast<int>(meal + 1));
+            config.rest.perform(gen);
+        }
+        log_event(id, LogEvent::COMPLETED);
+    }
+
+public:
+    explicit DiningPhilosophersWaiter(const DiningConfig& cfg)
+        : DiningTable(cfg), shard_mutex(effective_shards(cfg)),
+          chopstick_available(cfg.num_philosophers, 1), seats(cfg.num_philosophers) {}
+
+    const char* name() const override {
+        if (config.waiter_broadcast) return "waiter-bcast";
+        return shard_mutex.size() > 1 ? "waiter-shard" : "waiter";
+    }
+
+    int shards() const { return static_cast<int>(shard_mutex.size()); }
+
+    double wakeups_per_meal() const {
+        long long meals = 0;
+        long long wakeups = 0;
+        for (int i = 0; i < n; ++i) {
+            meals += stats[i].meals;
+            wakeups += seats[i].wakeups;
         }
-        cout << "Philosopher " << id << " completed all meals!" << endl;
+        return meals > 0 ? static_cast<double>(wakeups) / meals : 0;
+    }
+
+    void annotate(DiningResult& r) const override { r.wakeups_per_meal = wakeups_per_meal(); }
+
+    static DiningConfig demo_config() {
+        DiningConfig c = DiningConfig::defaults();
+        c.think = Workload::sleep_ms(400, 1200);
+        c.eat = Workload::sleep_ms(600, 600);
+        return c;
     }
-    
-public:
-    static void demonstrate() {
+
+    static DiningResult demonstrate() {
         cout << "\n=== WAITER-BASED DINING PHILOSOPHERS ===" << endl;
         cout << "Solution: Central waiter controls chopstick allocation" << endl;
         cout << "Benefits: Complete deadlock prevention, fair starvation prevention\n" << endl;
-        
-        // Initialize chopstick availability
-        fill(chopstick_available, chopstick_available + NUM_PHILOSOPHERS, true);
-        
-        vector<thread> philosophers;
-        
-        for (int i = 0; i < NUM_PHILOSOPHERS; ++i) {
-            philosophers.emplace_back(philosopher, i);
-        }
-        
-        for (auto& t : philosophers) {
-            t.join();
-        }
-        
+
+        DiningPhilosophersWaiter table(demo_config());
+        DiningResult r = table.run();
+
         cout << "\nAll philosophers finished dining! (Waiter solution)" << endl;
+        cout << "Wakeups per meal: " << table.wakeups_per_meal() << " (targeted neighbour wakeups)" << endl;
+        DiningReport::print(r);
+        return r;
     }
 };
 
-// Static member definitions
-mutex DiningPhilosophersWaiter::chopsticks[DiningPhilosophersWaiter::NUM_PHILOSOPHERS];
-mutex DiningPhilosophersWaiter::waiter_mutex;
-condition_variable DiningPhilosophersWaiter::waiter_cv;
-bool DiningPhilosophersWaiter::chopstick_available[DiningPhilosophersWaiter::NUM_PHILOSOPHERS];
-
 //=============================================================================
 // SOLUTION 3: TIMEOUT-BASED APPROACH (Practical Starvation Prevention)
 //=============================================================================
-class DiningPhilosophersTimeout {
+class DiningPhilosophersTimeout : public DiningTable {
 private:
-    static const int NUM_PHILOSOPHERS = 5;
-    static mutex chopsticks[NUM_PHILOSOPHERS];
-    static atomic<int> successful_meals;
-    static atomic<int> timeouts;
-    
-    // Helper function to try lock with timeout simulation (for C++11 compatibility)
-    static bool try_lock_with_timeout(mutex& mtx, int timeout_ms) {
-        // Simple timeout simulation using try_lock and sleep
-        auto start = steady_clock::now();
-        while (steady_clock::now() - start < milliseconds(timeout_ms)) {
-            if (mtx.try_lock()) {
-                return true;
-            }
-            this_thread::sleep_for(milliseconds(10)); // Small sleep to prevent busy waiting
-        }
-        return false;
+    PerSeat<TimedLock> chopsticks;
+    atomic<int> successful_meals;
+    atomic<int> timeouts;
+
+    // Real timed acquisition: spins, yields, then parks until the holder's
+    // unlock() wakes us or the timeout expires (no fixed polling interval)
+    bool try_lock_with_timeout(TimedLock& mtx, int timeout_units) {
+        return mtx.try_lock_for(microseconds(static_cast<long long>(timeout_units) * config.backoff_unit_us));
     }
-    
-    static void philosopher(int id) {
-        random_device rd;
-        mt19937 gen(rd());
-        uniform_int_distribution<> think_time(300, 1000);
-        
-        int meals_eaten = 0;
+
+    void philosopher(int id) override {
+        Pcg32 gen = rng_for(id);
+
+        long long meals_eaten = 0;
         int attempts = 0;
-        
-        while (meals_eaten < 3 && attempts < 10) { // Limit total attempts to prevent infinite loops
+        int consecutive_failures = 0;
+
+        // Limit total attempts to prevent infinite loops
+        while (keep_dining(meals_eaten) && (config.max_attempts == 0 || attempts < config.max_attempts)) {
             attempts++;
-            
+
             // THINKING
-            cout << "Philosopher " << id << " is thinking (attempt " << attempts << ")..." << endl;
-            this_thread::sleep_for(milliseconds(think_time(gen)));
-            
+            log_event(id, LogEvent::THINKING_ATTEMPT, attempts);
+            think(id, gen);
+
             // TRY TO ACQUIRE CHOPSTICKS WITH TIMEOUT
-            int left = id;
-            int right = (id + 1) % NUM_PHILOSOPHERS;
-            
+            int left = left_of(id);
+            int right = right_of(id);
+
             // Always try to acquire in consistent order to prevent some deadlocks
             if (left > right) swap(left, right);
-            
-            cout << "Philosopher " << id << " attempting to get chopsticks (timeout approach)..." << endl;
-            
+
+            log_event(id, LogEvent::TRYING_TIMEOUT);
+            auto hungry_since = steady_clock::now();
+
             // Try to lock first chopstick with timeout
-            if (try_lock_with_timeout(chopsticks[left], 1000)) {
-                cout << "Philosopher " << id << " got first chopstick " << left << endl;
-                
+            if (try_lock_with_timeout(chopsticks[left], config.lock_timeout_units)) {
+                log_event(id, LogEvent::GOT_FIRST, left);
+
                 // Try to lock second chopstick with timeout
-                if (try_lock_with_timeout(chopsticks[right], 1000)) {
-                    cout << "Philosopher " << id << " got second chopstick " << right << endl;
-                    
+                if (try_lock_with_timeout(chopsticks[right], config.lock_timeout_units)) {
+                    log_event(id, LogEvent::GOT_SECOND, right);
+                    record_meal(id, hungry_since, steady_clock::now());
+
                     // SUCCESS - EAT
                     meals_eaten++;
                     successful_meals++;
-                    cout << "*** Philosopher " << id << " is EATING (meal " << meals_eaten << ") ***" << endl;
-                    this_thread::sleep_for(milliseconds(700));
-                    
+                    consecutive_failures = 0;
+                    log_event(id, LogEvent::EATING_MEAL, static_cast<int>(meals_eaten));
+                    eat(id, gen);
+
                     // RELEASE CHOPSTICKS
                     chopsticks[right].unlock();
                     chopsticks[left].unlock();
-                    cout << "Philosopher " << id << " finished meal " << meals_eaten << endl;
-                    
+                    log_event(id, LogEvent::FINISHED_MEAL, static_cast<int>(meals_eaten));
+                    config.rest.perform(gen);
+
                 } else {
                     // TIMEOUT ON SECOND CHOPSTICK
                     timeouts++;
-                    cout << "Philosopher " << id << " timed out on second chopstick, backing off..." << endl;
+                    record_lock_failure(id);
+                    log_event(id, LogEvent::TIMEOUT_SECOND);
                     chopsticks[left].unlock();
-                    
-                    // Exponential backoff to reduce contention
-                    this_thread::sleep_for(milliseconds(100 * attempts));
+
+                    // Back off to reduce contention (policy decides how long)
+                    BackoffContext ctx = {attempts, ++consecutive_failures, true};
+                    backoff(config.backoff->delay_units(ctx, gen));
                 }
             } else {
                 // TIMEOUT ON FIRST CHOPSTICK
                 timeouts++;
-                cout << "Philosopher " << id << " timed out on first chopstick, will retry..." << endl;
-                
-                // Random backoff to break synchronization patterns
-                this_thread::sleep_for(milliseconds(50 + (gen() % 200)));
+                record_lock_failure(id);
+                log_event(id, LogEvent::TIMEOUT_FIRST);
+
+                // Randomized backoff breaks synchronization patterns
+                BackoffContext ctx = {attempts, ++consecutive_failures, false};
+                backoff(config.backoff->delay_units(ctx, gen));
             }
         }
-        
-        cout << "Philosopher " << id << " finished with " << meals_eaten << " meals eaten!" << endl;
+
+        log_event(id, LogEvent::FINISHED_WITH, static_cast<int>(meals_eaten));
     }
-    
+
 public:
-    static void demonstrate() {
+    explicit DiningPhilosophersTimeout(const DiningConfig& cfg)
+        : DiningTable(cfg), chopsticks(cfg.num_philosophers), successful_meals(0), timeouts(0) {}
+
+    const char* name() const override { return "timeout"; }
+
+    static DiningConfig demo_config() {
+        DiningConfig c = DiningConfig::defaults();
+        c.think = Workload::sleep_ms(300, 1000);
+        c.eat = Workload::sleep_ms(700, 700);
+        return c;
+    }
+
+    static DiningResult demonstrate() {
         cout << "\n=== TIMEOUT-BASED DINING PHILOSOPHERS ===" << endl;
         cout << "Solution: Use timeouts and backoff to prevent indefinite blocking" << endl;
         cout << "Benefits: Practical starvation prevention, handles contention gracefully\n" << endl;
-        
-        successful_meals = 0;
-        timeouts = 0;
-        
-        vector<thread> philosophers;
-        
-        for (int i = 0; i < NUM_PHILOSOPHERS; ++i) {
-            philosophers.emplace_back(philosopher, i);
-        }
-        
-        for (auto& t : philosophers) {
-            t.join();
-        }
-        
+
+        DiningPhilosophersTimeout table(demo_config());
+        DiningResult r = table.run();
+
         cout << "\nTimeout solution completed!" << endl;
-        cout << "Total successful meals: " << successful_meals.load() << endl;
-        cout << "Total timeouts: " << timeouts.load() << endl;
+        cout << "Total successful meals: " << table.successful_meals.load() << endl;
+        cout << "Total timeouts: " << table.timeouts.load() << endl;
+        DiningReport::print(r);
+        return r;
     }
 };
 
-// Static member definitions
-mutex DiningPhilosophersTimeout::chopsticks[DiningPhilosophersTimeout::NUM_PHILOSOPHERS];
-atomic<int> DiningPhilosophersTimeout::successful_meals(0);
-atomic<int> DiningPhilosophersTimeout::timeouts(0);
-
 //=============================================================================
 // SOLUTION 4: YOUR ORIGINAL APPROACH (Enhanced with better starvation handling)
 //=============================================================================
-class DiningPhilosophersOriginalEnhanced {
+class DiningPhilosophersOriginalEnhanced : public DiningTable {
 private:
-    static const int NUM_PHILOSOPHERS = 5;
-    static mutex chopsticks[NUM_PHILOSOPHERS];
-    static atomic<int> philosopher_priority[NUM_PHILOSOPHERS]; // Priority system to prevent starvation
-    
-    static void philosopher(int id) {
-        random_device rd;
-        mt19937 gen(rd());
-        uniform_int_distribution<> think_time(400, 1200);
-        
-        for (int i = 0; i < 3; ++i) {
+    PerSeat<mutex> chopsticks;
+    PerSeat<atomic<int>> philosopher_priority; // Priority system to prevent starvation
+
+    void philosopher(int id) override {
+        Pcg32 gen = rng_for(id);
+
+        for (long long i = 0; keep_dining(i); ++i) {
             // THINKING
-            cout << "Philosopher " << id << " is thinking (enhanced original)..." << endl;
-            this_thread::sleep_for(milliseconds(think_time(gen)));
-            
+            log_event(id, LogEvent::THINKING_ENHANCED);
+            think(id, gen);
+            auto hungry_since = steady_clock::now();
+
             // INCREASE PRIORITY (starvation prevention mechanism)
             philosopher_priority[id]++;
-            
+
             // ACQUIRE CHOPSTICKS (with resource ordering + priority-based backoff)
-            int left = id;
-            int right = (id + 1) % NUM_PHILOSOPHERS;
-            
+            int left = left_of(id);
+            int right = right_of(id);
+
             // Always pick up lower numbered chopstick first (your original insight)
             if (left > right) swap(left, right);
-            
+
             // Priority-based waiting to reduce starvation
             // Higher priority philosophers get less delay
             int priority = philosopher_priority[id].load();
             int delay = max(0, 100 - (priority * 20)); // Less delay for higher priority
-            this_thread::sleep_for(milliseconds(delay));
-            
-            cout << "Philosopher " << id << " (priority " << priority << ") trying to get chopsticks..." << endl;
-            
-            chopsticks[left].lock();
-            cout << "Philosopher " << id << " picked up left chopstick " << left << endl;
-            
-            chopsticks[right].lock();
-            cout << "Philosopher " << id << " picked up right chopstick " << right << endl;
-            
+            backoff(delay);
+
+            log_event(id, LogEvent::TRYING_PRIORITY, priority);
+
+            lock_counted(id, chopsticks[left]);
+            log_event(id, LogEvent::PICKED_LEFT, left);
+
+            lock_counted(id, chopsticks[right]);
+            log_event(id, LogEvent::PICKED_RIGHT, right);
+            record_meal(id, hungry_since, steady_clock::now());
+
             // EATING
-            cout << "*** Philosopher " << id << " is EATING (enhanced) ***" << endl;
-            this_thread::sleep_for(milliseconds(500 + (gen() % 300))); // Randomized eating time
-            
+            log_event(id, LogEvent::EATING_ENHANCED);
+            eat(id, gen); // Randomized eating time
+
             // RELEASE CHOPSTICKS
             chopsticks[right].unlock();
             chopsticks[left].unlock();
-            
+
             // RESET PRIORITY (philosopher got to eat)
             philosopher_priority[id] = 0;
-            
-            cout << "Philosopher " << id << " finished eating (priority reset)" << endl;
+
+            log_event(id, LogEvent::FINISHED_PRIORITY_RESET);
+            config.rest.perform(gen);
         }
-        cout << "Philosopher " << id << " completed all meals! (Enhanced Original)" << endl;
+        log_event(id, LogEvent::COMPLETED_ENHANCED);
     }
-    
+
 public:
-    static void demonstrate() {
+    explicit DiningPhilosophersOriginalEnhanced(const DiningConfig& cfg)
+        : DiningTable(cfg), chopsticks(cfg.num_philosophers), philosopher_priority(cfg.num_philosophers) {
+        // Initialize priorities
+        for (int i = 0; i < n; ++i) {
+            philosopher_priority[i] = 0;
+        }
+    }
+
+    const char* name() const override { return "ordered"; }
+
+    static DiningConfig demo_config() {
+        DiningConfig c = DiningConfig::defaults();
+        c.think = Workload::sleep_ms(400, 1200);
+        c.eat = Workload::sleep_ms(500, 799);
+        return c;
+    }
+
+    static DiningResult demonstrate() {
         cout << "\n=== ENHANCED ORIGINAL APPROACH ===" << endl;
         cout << "Solution: Resource ordering + priority-based starvation prevention" << endl;
         cout << "Benefits: Simple, efficient, with basic starvation mitigation\n" << endl;
-        
-        // Initialize priorities
-        for (int i = 0; i < NUM_PHILOSOPHERS; ++i) {
-            philosopher_priority[i] = 0;
+
+        DiningPhilosophersOriginalEnhanced table(demo_config());
+        DiningResult r = table.run();
+
+        cout << "\nAll philosophers finished dining! (Enhanced Original)" << endl;
+        DiningReport::print(r);
+        return r;
+    }
+};
+
+//=============================================================================
+// SOLUTION 5: CHANDY-MISRA (Message Passing with Clean/Dirty Forks)
+//=============================================================================
+// Each fork is a token owned by exactly one of its two philosophers, and a
+// second token, the request, travels the other way. A philosopher gives up a
+// fork only when asked and only if it is dirty (used since it last changed
+// hands); a fork arrives clean, so the receiver keeps it until it has eaten.
+// Forks start dirty at the lower id, which makes the precedence graph acyclic:
+// no deadlock, and every hungry philosopher eventually eats.
+//
+// There are no shared locks at all. Fork and request state lives on the
+// owning thread's stack; neighbours exchange it through a lock-free mailbox
+// word per philosopher (one bit per message kind and side) and park on that
+// word with the futex when there is nothing to do.
+class DiningPhilosophersChandyMisra : public DiningTable {
+private:
+    enum Side { LEFT = 0, RIGHT = 1 };
+
+    // Mailbox bits, named from the receiver's point of view
+    static const int REQUEST_FROM_LEFT = 1;
+    static const int REQUEST_FROM_RIGHT = 2;
+    static const int FORK_FROM_LEFT = 4;
+    static const int FORK_FROM_RIGHT = 8;
+    static const int STOP = 16;
+    static const int PARKED = 32;     // owner is (about to be) asleep on the word
+    static const int SPIN_LIMIT = 64;
+
+    // What one philosopher holds; touched only by its own thread
+    struct Hand {
+        bool fork[2];
+        bool dirty[2];
+        bool request[2];  // holding the request token lets us ask for the fork
+        bool hungry;
+        bool eating;
+    };
+
+    PerSeat<atomic<int>> mailbox;
+    atomic<int> still_dining;
+
+    int neighbour(int id, int side) const { return side == LEFT ? (id + n - 1) % n : (id + 1) % n; }
+    int fork_index(int id, int side) const { return side == LEFT ? left_of(id) : right_of(id); }
+
+    void post(int to, int bits) {
+        if (mailbox[to].fetch_or(bits) & PARKED) {
+            Futex::wake_one(mailbox[to]);
         }
+    }
+
+    // `from_left_bit` is REQUEST_FROM_LEFT or FORK_FROM_LEFT; the neighbour on
+    // our left receives it from its right, which is the next bit up
+    void send(int id, int side, int from_left_bit) {
+        post(neighbour(id, side), side == LEFT ? from_left_bit << 1 : from_left_bit);
+    }
+
+    int take_messages(int id) { return mailbox[id].exchange(0) & ~PARKED; }
+
+    // Next batch of messages; 0 once `deadline` passes (if it has one)
+    int receive(int id, const steady_clock::time_point* deadline) {
+        atomic<int>& box = mailbox[id];
+        for (int spins = 0;; ++spins) {
+            if (box.load(memory_order_relaxed) != 0) {
+                int messages = take_messages(id);
+                if (messages != 0) {
+                    return messages;
+                }
+            }
+            if (spins < SPIN_LIMIT) {
+                cpu_relax();
+                continue;
+            }
+            int expected = 0;
+            if (box.compare_exchange_strong(expected, PARKED)) {
+                if (!deadline) {
+                    Futex::wait(box, PARKED);
+                } else if (!Futex::wait_until(box, PARKED, *deadline)) {
+                    return take_messages(id);
+                }
+            }
+            if (deadline && steady_clock::now() >= *deadline) {
+                return take_messages(id);
+            }
+        }
+    }
+
+    void handle(int id, Hand& h, int messages) {
+        for (int side = LEFT; side <= RIGHT; ++side) {
+            if (messages & (FORK_FROM_LEFT << side)) {
+                h.fork[side] = true;
+                h.dirty[side] = false;
+                log_event(id, LogEvent::FORK_RECEIVED, fork_index(id, side));
+            }
+            if (messages & (REQUEST_FROM_LEFT << side)) {
+                h.request[side] = true;
+            }
+        }
+        serve(id, h);
+    }
+
+    // Hand over every requested dirty fork; ask for missing forks when hungry
+    void serve(int id, Hand& h) {
+        for (int side = LEFT; side <= RIGHT; ++side) {
+            if (h.request[side] && h.fork[side] && h.dirty[side] && !h.eating) {
+                h.fork[side] = false;
+                send(id, side, FORK_FROM_LEFT);
+                log_event(id, LogEvent::FORK_SENT, fork_index(id, side), neighbour(id, side));
+            }
+            if (h.hungry && h.request[side] && !h.fork[side]) {
+                h.request[side] = false;
+                send(id, side, REQUEST_FROM_LEFT);
+            }
+        }
+    }
+
+    // Think or rest while still answering the neighbours' requests
+    void idle(int id, Hand& h, const Workload& w, Pcg32& gen) {
+        int amount = w.draw(gen);
+        if (w.kind == Workload::SLEEP) {
+            steady_clock::time_point deadline = steady_clock::now() + microseconds(amount);
+            while (int messages = receive(id, &deadline)) {
+                handle(id, h, messages);
+            }
+        } else {
+            for (int i = 0; i < amount; ++i) {
+                cpu_relax();
+                if ((i & 63) == 63 && mailbox[id].load(memory_order_relaxed) != 0) {
+                    handle(id, h, take_messages(id));
+                }
+            }
+        }
+        if (mailbox[id].load(memory_order_relaxed) != 0) {
+            handle(id, h, take_messages(id));
+        }
+    }
+
+    void philosopher(int id) override {
+        Pcg32 gen = rng_for(id);
+
+        // Fork k lies between philosophers k-1 and k and starts dirty at the
+        // lower id of the two; the other one holds its request token
+        Hand h;
+        h.fork[LEFT] = (id == 0);
+        h.fork[RIGHT] = (id != n - 1);
+        for (int side = LEFT; side <= RIGHT; ++side) {
+            h.dirty[side] = true;
+            h.request[side] = !h.fork[side];
+        }
+        h.hungry = false;
+        h.eating = false;
+
+        for (long long meal = 0; keep_dining(meal); ++meal) {
+            // THINKING (still serving requests)
+            log_event(id, LogEvent::THINKING);
+            steady_clock::time_point thinking_since = steady_clock::now();
+            idle(id, h, config.think, gen);
+            stats[id].think_ns.record(elapsed_ns(thinking_since, steady_clock::now()));
+
+            // HUNGRY: request the missing forks and wait for them
+            auto hungry_since = steady_clock::now();
+            h.hungry = true;
+            int missing = !h.fork[LEFT] + !h.fork[RIGHT];
+            if (missing > 0) {
+                log_event(id, LogEvent::ASKS_NEIGHBOURS, missing);
+                record_lock_failure(id);
+            }
+            serve(id, h);
+            while (!(h.fork[LEFT] && h.fork[RIGHT])) {
+                handle(id, h, receive(id, nullptr));
+            }
+            h.hungry = false;
+            record_meal(id, hungry_since, steady_clock::now());
+
+            // EATING: both forks become dirty; requests wait until we are done
+            h.eating = true;
+            h.dirty[LEFT] = h.dirty[RIGHT] = true;
+            log_event(id, LogEvent::EATING_MEAL, static_cast<int>(meal + 1));
+            eat(id, gen);
+            h.eating = false;
+            serve(id, h);
+            log_event(id, LogEvent::FINISHED_MEAL, static_cast<int>(meal + 1));
+
+            idle(id, h, config.rest, gen);
+        }
+        log_event(id, LogEvent::COMPLETED);
+
+        // Neighbours may still need our forks: keep serving until the last
+        // philosopher has finished and tells everyone to leave the table
+        if (still_dining.fetch_sub(1) == 1) {
+            for (int p = 0; p < n; ++p) {
+                post(p, STOP);
+            }
+        }
+        for (;;) {
+            int messages = receive(id, nullptr);
+            handle(id, h, messages);
+            if (messages & STOP) {
+                break;
+            }
+        }
+    }
+
+public:
+    explicit DiningPhilosophersChandyMisra(const DiningConfig& cfg)
+        : DiningTable(cfg), mailbox(cfg.num_philosophers), still_dining(cfg.num_philosophers) {
+        for (int i = 0; i < n; ++i) {
+            mailbox[i] = 0;
+        }
+    }
+
+    const char* name() const override { return "chandy-misra"; }
+
+    static DiningConfig demo_config() {
+        DiningConfig c = DiningConfig::defaults();
+        c.think = Workload::sleep_ms(400, 1200);
+        c.eat = Workload::sleep_ms(600, 600);
+        return c;
+    }
+
+    static DiningResult demonstrate() {
+        cout << "\n=== CHANDY-MISRA DINING PHILOSOPHERS ===" << endl;
+        cout << "Solution: Forks are clean/dirty tokens passed between neighbours on request" << endl;
+        cout << "Benefits: No shared locks or central coordinator, only neighbours communicate\n" << endl;
+
+        DiningPhilosophersChandyMisra table(demo_config());
+        DiningResult r = table.run();
+
+        cout << "\nAll philosophers finished dining! (Chandy-Misra solution)" << endl;
+        DiningReport::print(r);
+        return r;
+    }
+};
+
+//=============================================================================
+// SEMAPHORE MICROBENCHMARK (fast-path Semaphore vs CondVarSemaphore)
+//=============================================================================
+class SemaphoreBenchmark {
+private:
+    // One thread, permits always available: pure fast-path cost
+    template <class Sem>
+    static double uncontended_ops_per_sec(int iterations) {
+        Sem sem(1);
+        auto start = steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            sem.acquire();
+            sem.release();
+        }
+        double seconds = duration<double>(steady_clock::now() - start).count();
+        return iterations / seconds;
+    }
+    
+    // Many threads fighting over few permits: exercises the parking slow path
+    template <class Sem>
+    static double contended_ops_per_sec(int num_threads, int permits, int iterations_per_thread) {
+        Sem sem(permits);
+        atomic<bool> go(false);
+        vector<thread> threads;
         
-        vector<thread> philosophers;
-        
-        for (int i = 0; i < NUM_PHILOSOPHERS; ++i) {
-            philosophers.emplace_back(philosopher, i);
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&sem, &go, iterations_per_thread] {
+                while (!go.load()) {
+                    this_thread::yield();
+                }
+                for (int i = 0; i < iterations_per_thread; ++i) {
+                    sem.acquire();
+                    sem.release();
+                }
+            });
         }
         
-        for (auto& t : philosophers) {
+        auto start = steady_clock::now();
+        go = true;
+        for (auto& t : threads) {
             t.join();
         }
+        double seconds = duration<double>(steady_clock::now() - start).count();
+        return static_cast<double>(num_threads) * iterations_per_thread / seconds;
+    }
+    
+    static void report(const char* scenario, double baseline, double fast) {
+        cout << left << setw(34) << scenario << right
+             << setw(16) << fixed << setprecision(0) << baseline
+             << setw(16) << fast
+             << setw(10) << setprecision(2) << fast / baseline << "x" << endl;
+    }
+    
+public:
+    static void run() {
+        const int uncontended_iterations = 5000000;
+        const int contended_iterations = 200000;
+        int cores = max(2, static_cast<int>(thread::hardware_concurrency()));
         
-        cout << "\nAll philosophers finished dining! (Enhanced Original)" << endl;
+        cout << "\n=== SEMAPHORE MICROBENCHMARK (acquire+release pairs/sec) ===" << endl;
+        cout << left << setw(34) << "Scenario" << right
+             << setw(16) << "CondVar" << setw(16) << "Fast-path" << setw(11) << "Speedup" << endl;
+        
+        report("uncontended (1 thread)",
+               uncontended_ops_per_sec<CondVarSemaphore>(uncontended_iterations),
+               uncontended_ops_per_sec<Semaphore>(uncontended_iterations));
+        
+        string scenario = "contended (" + to_string(cores) + " threads, " + to_string(cores - 1) + (cores - 1 == 1 ? " permit)" : " permits)");
+        report(scenario.c_str(),
+               contended_ops_per_sec<CondVarSemaphore>(cores, cores - 1, contended_iterations),
+               contended_ops_per_sec<Semaphore>(cores, cores - 1, contended_iterations));
+        
+        scenario = "contended (" + to_string(cores * 2) + " threads, 1 permit)";
+        report(scenario.c_str(),
+               contended_ops_per_sec<CondVarSemaphore>(cores * 2, 1, contended_iterations),
+               contended_ops_per_sec<Semaphore>(cores * 2, 1, contended_iterations));
+    }
+};
+
+//=============================================================================
+// DINING BENCHMARK DRIVER (meals/sec, acquisition latency, fairness vs cores)
+//=============================================================================
+class DiningBenchmark {
+public:
+    static const char* const STRATEGIES;
+
+    static DiningTable* make_table(const string& strategy, const DiningConfig& c) {
+        if (strategy == "semaphore") return new DiningPhilosophersSemaphore(c);
+        if (strategy == "waiter") {
+            DiningConfig central = c;
+            central.waiter_shards = 1;
+            return new DiningPhilosophersWaiter(central);
+        }
+        if (strategy == "waiter-bcast") {
+            DiningConfig broadcast = c;
+            broadcast.waiter_broadcast = true;
+            return new DiningPhilosophersWaiter(broadcast);
+        }
+        if (strategy == "waiter-shard") {
+            DiningConfig sharded = c;
+            sharded.waiter_shards = max(2, c.waiter_shards);
+            return new DiningPhilosophersWaiter(sharded);
+        }
+        if (strategy == "timeout") return new DiningPhilosophersTimeout(c);
+        if (strategy == "ordered") return new DiningPhilosophersOriginalEnhanced(c);
+        if (strategy == "chandy-misra") return new DiningPhilosophersChandyMisra(c);
+        return nullptr;
+    }
+
+    static vector<string> split(const string& text) {
+        vector<string> parts;
+        size_t begin = 0;
+        while (begin <= text.size()) {
+            size_t end = text.find(',', begin);
+            if (end == string::npos) end = text.size();
+            if (end > begin) parts.push_back(text.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        return parts;
+    }
+
+    static int available_cores() {
+#if defined(__linux__)
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            return CPU_COUNT(&set);
+        }
+#endif
+        return max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+
+    // Restrict the calling thread (and every thread it creates afterwards) to
+    // its first `cores` allowed CPUs. Returns false where affinity is unsupported.
+    static bool restrict_to_cores(int cores) {
+#if defined(__linux__)
+        static cpu_set_t original;
+        static bool saved = false;
+        if (!saved) {
+            saved = sched_getaffinity(0, sizeof(original), &original) == 0;
+        }
+        if (!saved) {
+            return false;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0, taken = 0; cpu < CPU_SETSIZE && taken < cores; ++cpu) {
+            if (CPU_ISSET(cpu, &original)) {
+                CPU_SET(cpu, &set);
+                ++taken;
+            }
+        }
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+        (void)cores;
+        return false;
+#endif
+    }
+
+private:
+    static int usage() {
+        cerr << "usage: dinning-philosophers --bench [options]\n"
+             << "  --philosophers N      seats at the table (default 64)\n"
+             << "  --meals M             meals per philosopher, 0 = timed run (default 0)\n"
+             << "  --duration-ms T       length of a timed run (default 1000)\n"
+             << "  --think W             none | sleep:LO-HI (ms) | spin:LO-HI (iterations)\n"
+             << "  --eat W               same format as --think (default spin:0-1000)\n"
+             << "  --rest W              pause after each meal (default none)\n"
+             << "  --cores 2,4,8         core counts to sweep (default 2,4,.. up to all)\n"
+             << "  --strategies LIST     subset of " << STRATEGIES << "\n"
+             << "  --backoff-unit-us U   length of one built-in delay unit (default 10)\n"
+             << "  --waiter-shards K     coordinators for waiter-shard (default: one per core)\n"
+             << "  --lock-timeout U      timeout strategy: wait per chopstick, in units (default 1000)\n"
+             << "  --backoff P           timeout strategy: classic | linear:STEP | exponential:BASE-CAP\n"
+             << "                        | jitter:BASE-SPREAD, all in units (default exponential:1-1000)\n"
+             << "  --seed S              fixed PRNG seed for reproducible runs\n"
+             << "  --log                 narrate every transition through the event log\n"
+             << "  --json FILE           export every run (aggregate + per-philosopher) as JSON\n"
+             << "  --csv FILE            export one row per philosopher per run as CSV" << endl;
+        return 2;
+    }
+
+    static void print_header() {
+        cout << left << setw(14) << "strategy" << right
+             << setw(6) << "cores" << setw(8) << "seats" << setw(10) << "meals"
+             << setw(14) << "meals/sec" << setw(12) << "p50 us" << setw(12) << "p99 us"
+             << setw(10) << "fairness" << setw(14) << "min/max" << setw(11) << "wake/meal" << endl;
+    }
+
+    static void print_row(const DiningResult& r, int cores) {
+        string spread = to_string(r.min_meals) + "/" + to_string(r.max_meals);
+        cout << left << setw(14) << r.strategy << right
+             << setw(6) << cores << setw(8) << r.philosophers << setw(10) << r.total_meals
+             << setw(14) << fixed << setprecision(0) << r.meals_per_sec
+             << setw(12) << setprecision(2) << r.wait_us.p50
+             << setw(12) << r.wait_us.p99
+             << setw(10) << setprecision(3) << r.fairness
+             << setw(14) << spread;
+        if (r.wakeups_per_meal >= 0) {
+            cout << setw(11) << setprecision(2) << r.wakeups_per_meal;
+        } else {
+            cout << setw(11) << "-";
+        }
+        cout << endl;
+    }
+
+public:
+    // Runs every strategy with spin workloads and fails if any philosopher
+    // loop allocated. Needs a -DDINING_COUNT_ALLOCATIONS build.
+    static int check_allocations() {
+        if (allocation_count() < 0) {
+            cerr << "rebuild with -DDINING_COUNT_ALLOCATIONS to count allocations" << endl;
+            return 2;
+        }
+        DiningConfig c = DiningConfig::defaults();
+        c.num_philosophers = 8;
+        c.meals = 200;
+        c.think = Workload::spin(0, 200);
+        c.eat = Workload::spin(0, 200);
+        c.backoff_unit_us = 1;
+        c.lock_timeout_units = 50;
+        c.max_attempts = 0;
+        c.backoff = make_shared<ExponentialBackoff>(1, 50);
+        c.waiter_shards = 2;
+        c.verbose = false;
+
+        cout << "\n=== ALLOCATION CHECK (heap allocations inside philosopher loops) ===" << endl;
+        bool clean = true;
+        for (const string& strategy : split(STRATEGIES)) {
+            unique_ptr<DiningTable> table(make_table(strategy, c));
+            DiningResult r = table->run();
+            cout << left << setw(14) << strategy << right << setw(8) << r.total_meals << " meals"
+                 << setw(8) << r.allocations << " allocations  " << (r.allocations == 0 ? "PASS" : "FAIL") << endl;
+            clean = clean && r.allocations == 0;
+        }
+        return clean ? 0 : 1;
+    }
+
+    static int run(int argc, char* argv[]) {
+        DiningConfig c = DiningConfig::defaults();
+        c.num_philosophers = 64;
+        c.meals = 0;
+        c.think = Workload::spin(0, 1000);
+        c.eat = Workload::spin(0, 1000);
+        c.backoff_unit_us = 10;
+        c.max_attempts = 0;
+        c.backoff = make_shared<ExponentialBackoff>(1, 1000);
+        c.verbose = false;
+        vector<string> strategies = split(STRATEGIES);
+        vector<int> core_counts;
+        int waiter_shards = 0;
+        string json_path, csv_path;
+
+        for (int i = 2; i < argc; ++i) {
+            string opt = argv[i];
+            if (opt == "--log") {
+                c.verbose = true;
+                continue;
+            }
+            if (i + 1 >= argc) return usage();
+            string value = argv[++i];
+            if (opt == "--philosophers") c.num_philosophers = atoi(value.c_str());
+            else if (opt == "--meals") c.meals = atoi(value.c_str());
+            else if (opt == "--duration-ms") c.duration_ms = atoi(value.c_str());
+            else if (opt == "--think") { if (!Workload::parse(value, c.think)) return usage(); }
+            else if (opt == "--eat") { if (!Workload::parse(value, c.eat)) return usage(); }
+            else if (opt == "--rest") { if (!Workload::parse(value, c.rest)) return usage(); }
+            else if (opt == "--backoff-unit-us") c.backoff_unit_us = atoi(value.c_str());
+            else if (opt == "--strategies") strategies = split(value);
+            else if (opt == "--waiter-shards") waiter_shards = atoi(value.c_str());
+            else if (opt == "--lock-timeout") c.lock_timeout_units = atoi(value.c_str());
+            else if (opt == "--seed") c.seed = strtoull(value.c_str(), nullptr, 10);
+            else if (opt == "--json") json_path = value;
+            else if (opt == "--csv") csv_path = value;
+            else if (opt == "--backoff") { if (!(c.backoff = BackoffPolicy::parse(value))) return usage(); }
+            else if (opt == "--cores") {
+                for (const string& s : split(value)) core_counts.push_back(atoi(s.c_str()));
+            }
+            else return usage();
+        }
+        if (c.num_philosophers < 2 || c.meals < 0 || c.duration_ms <= 0 || c.backoff_unit_us <= 0
+            || c.lock_timeout_units <= 0) {
+            return usage();
+        }
+
+        int cores_available = available_cores();
+        if (core_counts.empty()) {
+            for (int k = 2; k < cores_available; k *= 2) core_counts.push_back(k);
+            core_counts.push_back(cores_available);
+        }
+
+        cout << "\n=== DINING PHILOSOPHERS BENCHMARK ===" << endl;
+        cout << c.num_philosophers << " philosophers, "
+             << (c.meals > 0 ? to_string(c.meals) + " meals each" : to_string(c.duration_ms) + " ms per run")
+             << ", " << cores_available << " cores available, "
+             << (DINING_PADDED_LAYOUT ? "padded" : "packed") << " layout ("
+             << PerSeat<mutex>::stride() << "-byte mutex slots)" << endl;
+        print_header();
+        vector<DiningResult> results;
+
+        for (int cores : core_counts) {
+            int used = max(1, min(cores, cores_available));
+            if (!restrict_to_cores(used)) {
+                used = cores_available;
+            }
+            c.waiter_shards = waiter_shards > 0 ? waiter_shards : used;
+            for (const string& strategy : strategies) {
+                unique_ptr<DiningTable> table(make_table(strategy, c));
+                if (!table) {
+                    cerr << "unknown strategy: " << strategy << endl;
+                    return usage();
+                }
+                DiningResult r = table->run();
+                r.cores = used;
+                print_row(r, used);
+                results.push_back(r);
+            }
+        }
+        restrict_to_cores(cores_available);
+        return DiningReport::export_results(json_path, csv_path, results) ? 0 : 1;
     }
 };
 
-// Static member definitions  
-mutex DiningPhilosophersOriginalEnhanced::chopsticks[DiningPhilosophersOriginalEnhanced::NUM_PHILOSOPHERS];
-atomic<int> DiningPhilosophersOriginalEnhanced::philosopher_priority[DiningPhilosophersOriginalEnhanced::NUM_PHILOSOPHERS];
+const char* const DiningBenchmark::STRATEGIES = "semaphore,waiter,waiter-bcast,waiter-shard,timeout,ordered,chandy-misra";
 
 //=============================================================================
-// DEMONSTRATION RUNNER
+// DEMONSTRATION RUNNER (define DINING_NO_MAIN to reuse the engines elsewhere)
 //=============================================================================
-int main() {
+#ifndef DINING_NO_MAIN
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench-semaphore") {
+        SemaphoreBenchmark::run();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        return DiningBenchmark::run(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--check-allocations") {
+        return DiningBenchmark::check_allocations();
+    }
+    
     cout << "DINING PHILOSOPHERS PROBLEM - DEADLOCK & STARVATION SOLUTIONS" << endl;
     cout << "=============================================================" << endl;
     cout << "Compatible with C++11/14/17 standards" << endl;
     
+    // Optional export of the per-thread instrumentation
+    string json_path, csv_path;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string opt = argv[i];
+        if (opt == "--json") json_path = argv[i + 1];
+        else if (opt == "--csv") csv_path = argv[i + 1];
+    }
+
     // Run each solution with delays between them
-    DiningPhilosophersSemaphore::demonstrate();
+    vector<DiningResult> results;
+    results.push_back(DiningPhilosophersSemaphore::demonstrate());
+    this_thread::sleep_for(seconds(2));
+    
+    results.push_back(DiningPhilosophersWaiter::demonstrate());
     this_thread::sleep_for(seconds(2));
     
-    DiningPhilosophersWaiter::demonstrate();
+    results.push_back(DiningPhilosophersTimeout::demonstrate());
     this_thread::sleep_for(seconds(2));
     
-    DiningPhilosophersTimeout::demonstrate();
+    results.push_back(DiningPhilosophersOriginalEnhanced::demonstrate());
     this_thread::sleep_for(seconds(2));
     
-    DiningPhilosophersOriginalEnhanced::demonstrate();
+    results.push_back(DiningPhilosophersChandyMisra::demonstrate());
     
     cout << "\n=== ANALYSIS ===" << endl;
     cout << "1. SEMAPHORE: Best balance of simplicity and effectiveness" << endl;
     cout << "2. WAITER: Most fair, but centralized bottleneck" << endl;
     cout << "3. TIMEOUT: Most practical for real systems with contention" << endl;
     cout << "4. ENHANCED ORIGINAL: Your approach with priority-based improvements" << endl;
+    cout << "5. CHANDY-MISRA: Purely local coordination, no shared locks or central waiter" << endl;
     
-    return 0;
+    return DiningReport::export_results(json_path, csv_path, results) ? 0 : 1;
 }
+#endif
 
 /*
 COMPILATION INSTRUCTIONS:
@@ -476,10 +2458,45 @@ For C++17: g++ -std=c++17 -pthread dinning-philosophers.cpp -o dinning-philosoph
 
 The -pthread flag is essential for thread support!
 
+Semaphore microbenchmark (fast-path Semaphore vs original CondVarSemaphore):
+  g++ -std=c++11 -O2 -pthread dinning-philosophers.cpp -o dinning-philosophers
+  ./dinning-philosophers --bench-semaphore
+
+Strategy benchmark (meals/sec, p50/p99 acquisition latency, fairness, 2..N cores):
+  ./dinning-philosophers --bench --philosophers 1000 --think spin:0-2000 --eat spin:0-2000
+  ./dinning-philosophers --bench --meals 50 --think none --eat none --cores 2,8,32
+
+Instrumentation: every philosopher records think / wait / eat time histograms,
+lock-acquisition failures and (semaphore strategy) the semaphore queue depth
+into its own cache line; they are merged once the table stops. Each demo prints
+the summary, and both the demos and --bench can export it:
+  ./dinning-philosophers --json runs.json --csv seats.csv
+  ./dinning-philosophers --bench --cores 2,8 --json bench.json --csv bench.csv
+
+Allocation check (every philosopher loop must do zero heap allocations):
+  g++ -std=c++11 -O2 -pthread -DDINING_COUNT_ALLOCATIONS dinning-philosophers.cpp -o dp-alloc
+  ./dp-alloc --check-allocations
+
+Logging: state transitions go through the asynchronous EventLog; build with
+  -DDINING_LOGGING=0 to remove the narration (and its writer thread) entirely.
+
+False-sharing comparison (per-seat state on its own cache line vs packed):
+  g++ -std=c++11 -O2 -pthread -DDINING_PADDED_LAYOUT=0 dinning-philosophers.cpp -o dp-packed
+  g++ -std=c++11 -O2 -pthread -DDINING_PADDED_LAYOUT=1 dinning-philosophers.cpp -o dp-padded
+  perf c2c record ./dp-packed --bench --think none --eat none && perf c2c report
+  Fairness is Jain's index over meals per philosopher (1.000 = perfectly even);
+  use timed runs (the default, --meals 0) for meaningful fairness numbers.
+
+Reuse: with -DDINING_NO_MAIN this file can be #included by another program.
+synchronization_benchmark.cpp (Lab/chapter6_worksheet.md, Part 7.1) does that
+to time the Semaphore, TimedLock and every dining engine along with the other
+chapter 6 primitives.
+
 SOLUTION COMPARISON:
 
 1. SEMAPHORE APPROACH (Custom implementation):
    - Deadlock Prevention: ✅ (limits concurrent diners)
+   - Semaphore: atomic fast path, futex/parking slow path only under contention
    - Starvation Prevention: ⚠️ (reduced but not eliminated)
    - Performance: Good
    - Complexity: Low
@@ -487,14 +2504,19 @@ SOLUTION COMPARISON:
 
 2. WAITER APPROACH:
    - Deadlock Prevention: ✅ (centralized control)
-   - Starvation Prevention: ✅ (fair FIFO ordering)
-   - Performance: Moderate (centralized bottleneck)
+   - Starvation Prevention: ✅ (fair FIFO ordering: never overtakes an older hungry neighbour)
+   - Wakeups: targeted, a return only wakes the neighbour it hands chopsticks to
+   - Performance: Moderate (centralized bottleneck); waiter_shards > 1 splits the
+     table into segments with one coordinator each, so only boundary seats
+     need two coordinators and arbitration scales with cores
    - Complexity: Medium
    - Compatibility: C++11+
 
 3. TIMEOUT APPROACH:
    - Deadlock Prevention: ✅ (timeouts break deadlock)
    - Starvation Prevention: ✅ (backoff ensures eventual success)
+   - Chopsticks are TimedLocks (spin, yield, then futex park with a deadline);
+     the retry delay is a pluggable BackoffPolicy (classic/linear/exponential/jitter)
    - Performance: Good under contention
    - Complexity: Medium
    - Compatibility: C++11+
@@ -506,5 +2528,15 @@ SOLUTION COMPARISON:
    - Complexity: Low
    - Compatibility: C++11+
 
+5. CHANDY-MISRA APPROACH:
+   - Deadlock Prevention: ✅ (dirty forks start at the lower id: acyclic precedence)
+   - Starvation Prevention: ✅ (a clean fork is kept until its holder has eaten)
+   - Coordination: purely local, neighbours exchange fork/request tokens through
+     lock-free per-philosopher mailboxes; no shared locks, semaphore or waiter
+   - Performance: Scales with the table, since traffic never leaves a neighbourhood
+     (compare against semaphore with --strategies semaphore,chandy-misra)
+   - Complexity: Medium-High
+   - Compatibility: C++11+
+
 RECOMMENDED: Semaphore approach for most cases, Waiter for strict fairness
 */
@@ -0,0 +1,209 @@
+/*
+ * process_names.h - cached PID -> executable name resolver
+ *
+ * GetProcessNameByPID() used to take a Toolhelp snapshot and scan every
+ * process on each call. ProcessNameCache takes one snapshot into an
+ * open-addressing hash table and answers lookups from memory. A miss
+ * triggers one re-snapshot, at most every PROCESS_NAMES_REFRESH_MS, so a PID
+ * that is simply not there does not cost a snapshot per lookup. The
+ * re-snapshot updates the table in place: every entry it
+ * sees is stamped with the new generation, and entries left on an older
+ * generation belong to processes that have exited; they are dropped when the
+ * table is next rebuilt. When the caller already holds a process handle (for
+ * example pi.hProcess), ProcessNameCacheFromHandle() asks the kernel directly
+ * with QueryFullProcessImageNameW, needs no snapshot at all, and cannot be
+ * fooled by PID reuse.
+ */
+#ifndef PROCESS_NAMES_H
+#define PROCESS_NAMES_H
+
+#include <windows.h>
+#include <tlhelp32.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROCESS_NAMES_REFRESH_MS 100  /* misses re-snapshot at most this often */
+
+typedef struct {
+    DWORD pid;          /* 0 = empty slot (PID 0 is the idle process, never looked up) */
+    DWORD generation;   /* snapshot that last saw this PID */
+    char name[MAX_PATH];
+} ProcessNameEntry;
+
+typedef struct {
+    ProcessNameEntry *slots;
+    size_t capacity;    /* power of two */
+    size_t used;        /* occupied slots, live or stale */
+    DWORD generation;
+    unsigned long snapshots;
+    ULONGLONG lastRefresh;  /* GetTickCount64() of the latest snapshot */
+} ProcessNameCache;
+
+static size_t ProcessNameSlot(const ProcessNameCache *cache, DWORD pid) {
+    /* PIDs are multiples of 4 on Windows; mix before masking */
+    DWORD h = pid * 2654435761u;
+    return (size_t)(h ^ (h >> 16)) & (cache->capacity - 1);
+}
+
+static ProcessNameEntry *ProcessNameFind(ProcessNameCache *cache, DWORD pid) {
+    size_t i = ProcessNameSlot(cache, pid);
+    while (cache->slots[i].pid != 0) {
+        if (cache->slots[i].pid == pid) {
+            return &cache->slots[i];
+        }
+        i = (i + 1) & (cache->capacity - 1);
+    }
+    return NULL;
+}
+
+static BOOL ProcessNameCacheAlloc(ProcessNameCache *cache, size_t capacity) {
+    ProcessNameEntry *slots = (ProcessNameEntry *)calloc(capacity, sizeof(ProcessNameEntry));
+    if (slots == NULL) {
+        return FALSE;
+    }
+    cache->slots = slots;
+    cache->capacity = capacity;
+    cache->used = 0;
+    return TRUE;
+}
+
+/* Rehash only the entries the latest snapshot saw, into a table with room to spare */
+static void ProcessNameCacheRebuild(ProcessNameCache *cache, size_t live) {
+    ProcessNameEntry *old = cache->slots;
+    size_t oldCapacity = cache->capacity;
+    size_t capacity = 64;
+    size_t i;
+
+    while (capacity < live * 2) {
+        capacity *= 2;
+    }
+    if (!ProcessNameCacheAlloc(cache, capacity)) {
+        return;  /* keep the old table */
+    }
+    for (i = 0; i < oldCapacity; ++i) {
+        if (old[i].pid != 0 && old[i].generation == cache->generation) {
+            size_t j = ProcessNameSlot(cache, old[i].pid);
+            while (cache->slots[j].pid != 0) {
+                j = (j + 1) & (cache->capacity - 1);
+            }
+            cache->slots[j] = old[i];
+            ++cache->used;
+        }
+    }
+    free(old);
+}
+
+/* FALSE if a new PID found the table at its load limit and it could not grow */
+static BOOL ProcessNameCacheStore(ProcessNameCache *cache, DWORD pid, const char *name) {
+    ProcessNameEntry *entry;
+
+    if (pid == 0) {
+        return TRUE;
+    }
+    if ((cache->used + 1) * 4 > cache->capacity * 3) {
+        ProcessNameCacheRebuild(cache, cache->used + 1);
+    }
+    entry = ProcessNameFind(cache, pid);
+    if (entry == NULL) {
+        /* Past 3/4 full the probe chains degrade; a full table would never end one */
+        if ((cache->used + 1) * 4 > cache->capacity * 3) {
+            return FALSE;
+        }
+        size_t i = ProcessNameSlot(cache, pid);
+        while (cache->slots[i].pid != 0) {
+            i = (i + 1) & (cache->capacity - 1);
+        }
+        entry = &cache->slots[i];
+        entry->pid = pid;
+        ++cache->used;
+    }
+    entry->generation = cache->generation;
+    snprintf(entry->name, sizeof(entry->name), "%s", name);
+    return TRUE;
+}
+
+/* One snapshot: add new processes, refresh existing ones, retire the rest */
+static void ProcessNameCacheRefresh(ProcessNameCache *cache) {
+    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    PROCESSENTRY32W pe;
+    size_t live = 0;
+    char name[MAX_PATH];
+
+    if (hSnapshot == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    ++cache->generation;
+    ++cache->snapshots;
+    cache->lastRefresh = GetTickCount64();
+    pe.dwSize = sizeof(pe);
+    if (Process32FirstW(hSnapshot, &pe)) {
+        do {
+            WideCharToMultiByte(CP_ACP, 0, pe.szExeFile, -1, name, (int)sizeof(name), NULL, NULL);
+            ProcessNameCacheStore(cache, pe.th32ProcessID, name);
+            ++live;
+        } while (Process32NextW(hSnapshot, &pe));
+    }
+    CloseHandle(hSnapshot);
+
+    /* Mostly exited processes: compact */
+    if (cache->used > live * 2) {
+        ProcessNameCacheRebuild(cache, live);
+    }
+}
+
+/* FALSE if the table could not be allocated; the cache must not be used then */
+static BOOL ProcessNameCacheInit(ProcessNameCache *cache) {
+    cache->generation = 0;
+    cache->snapshots = 0;
+    cache->lastRefresh = 0;
+    if (!ProcessNameCacheAlloc(cache, 1024)) {
+        return FALSE;
+    }
+    ProcessNameCacheRefresh(cache);
+    return TRUE;
+}
+
+static void ProcessNameCacheFree(ProcessNameCache *cache) {
+    free(cache->slots);
+    cache->slots = NULL;
+    cache->capacity = cache->used = 0;
+}
+
+/* Cached lookup; a miss (or a process gone since the last snapshot) costs one
+   refresh, unless the table was refreshed within PROCESS_NAMES_REFRESH_MS */
+static void ProcessNameCacheLookup(ProcessNameCache *cache, DWORD pid, char *name, size_t size) {
+    ProcessNameEntry *entry = ProcessNameFind(cache, pid);
+
+    if ((entry == NULL || entry->generation != cache->generation) &&
+        GetTickCount64() - cache->lastRefresh >= PROCESS_NAMES_REFRESH_MS) {
+        ProcessNameCacheRefresh(cache);
+        entry = ProcessNameFind(cache, pid);
+    }
+    if (entry != NULL && entry->generation == cache->generation) {
+        snprintf(name, size, "%s", entry->name);
+    } else {
+        snprintf(name, size, "<Unknown>");
+    }
+}
+
+/* Direct hit through a handle we already hold; falls back to the cache */
+static void ProcessNameCacheFromHandle(ProcessNameCache *cache, HANDLE hProcess, DWORD pid,
+                                       char *name, size_t size) {
+    WCHAR path[MAX_PATH];
+    DWORD length = MAX_PATH;
+    char converted[MAX_PATH];
+    const char *base;
+
+    if (!QueryFullProcessImageNameW(hProcess, 0, path, &length)) {
+        ProcessNameCacheLookup(cache, pid, name, size);
+        return;
+    }
+    WideCharToMultiByte(CP_ACP, 0, path, -1, converted, (int)sizeof(converted), NULL, NULL);
+    base = strrchr(converted, '\\');
+    base = base ? base + 1 : converted;
+    ProcessNameCacheStore(cache, pid, base);  /* same spelling as the snapshot's szExeFile */
+    snprintf(name, size, "%s", base);
+}
+
+#endif /* PROCESS_NAMES_H */
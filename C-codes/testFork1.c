@@ -1,19 +1,30 @@
 // ID : 654244001 Name : Suwat Ta
 #include <windows.h>
 #include <stdio.h>
+#include <string.h>
 
-int main() {
-    STARTUPINFO si;
+int main(int argc, char *argv[]) {
+    STARTUPINFOA si;
     PROCESS_INFORMATION pi;
     DWORD parentPID = GetCurrentProcessId(); // Parent PID
+    char childPath[MAX_PATH + 16];
+    char *slash;
 
     ZeroMemory(&si, sizeof(si));
     si.cb = sizeof(si);
     ZeroMemory(&pi, sizeof(pi));
 
-    // --------- child process: Child1.exe
-    if (!CreateProcess(
-        "E:\\Suwat\\C-codes\\Child1.exe", // Application name
+    // --------- child process: Child1.exe next to this program (or argv[1])
+    if (argc > 1) {
+        snprintf(childPath, sizeof(childPath), "%s", argv[1]);
+    } else {
+        GetModuleFileNameA(NULL, childPath, MAX_PATH);
+        slash = strrchr(childPath, '\\');
+        strcpy(slash ? slash + 1 : childPath, "Child1.exe");  // buffer has room past MAX_PATH
+    }
+
+    if (!CreateProcessA(
+        childPath, // Application name (used as is, so spaces need no quoting)
 
         NULL,      // Command line arguments
         NULL,      // Process handle not inheritable
@@ -1,31 +1,115 @@
 #include <windows.h>
 #include <tlhelp32.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "process_names.h"
 
-void GetProcessNameByPID(DWORD pid, char *name, size_t size) {
-    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    PROCESSENTRY32W pe;  // Use wide-char version
-    pe.dwSize = sizeof(pe);
-
-    if (Process32FirstW(hSnapshot, &pe)) {
-        do {
-            if (pe.th32ProcessID == pid) {
-                // Convert wide string to ANSI
-                WideCharToMultiByte(CP_ACP, 0, pe.szExeFile, -1, name, (int)size, NULL, NULL);
-                CloseHandle(hSnapshot);
-                return;
+/*
+ * Supervisor mode: keep up to MAXIMUM_WAIT_OBJECTS (64) children running and
+ * collect each one with WaitForMultipleObjects as soon as it exits, instead of
+ * blocking in WaitForSingleObject on one child at a time. The parent does its
+ * own work whenever no child has exited.
+ */
+typedef struct {
+    HANDLE process;
+    DWORD pid;
+    int tag;
+} RunningChild;
+
+/* Child for task `tag`: cmd.exe exits with the tag as its code; every tenth
+   one exits with STATUS_CONTROL_C_EXIT to stand in for an abnormal end. */
+static BOOL StartChild(int tag, RunningChild *child) {
+    STARTUPINFOA si;
+    PROCESS_INFORMATION pi;
+    char cmdLine[128];
+    long code = (tag % 10 == 9) ? (long)0xC000013AL : (long)(tag % 100);
+
+    ZeroMemory(&si, sizeof(si));
+    si.cb = sizeof(si);
+    ZeroMemory(&pi, sizeof(pi));
+    snprintf(cmdLine, sizeof(cmdLine), "C:\\Windows\\System32\\cmd.exe /c exit %ld", code);
+
+    if (!CreateProcessA(NULL, cmdLine, NULL, NULL, FALSE, CREATE_NO_WINDOW,
+                        NULL, NULL, &si, &pi)) {
+        return FALSE;
+    }
+    CloseHandle(pi.hThread);
+    child->process = pi.hProcess;
+    child->pid = pi.dwProcessId;
+    child->tag = tag;
+    return TRUE;
+}
+
+static int Supervise(int total) {
+    RunningChild children[MAXIMUM_WAIT_OBJECTS];
+    HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+    int running = 0, launched = 0, finished = 0;
+    int normal = 0, abnormal = 0;
+    unsigned long long workSlices = 0;
+    DWORD start = GetTickCount();
+
+    printf("Supervising %d children, up to %d at once\n", total, MAXIMUM_WAIT_OBJECTS);
+    while (finished < total) {
+        DWORD result;
+        DWORD exitCode = 0;
+        int i;
+
+        while (launched < total && running < MAXIMUM_WAIT_OBJECTS) {
+            if (!StartChild(launched, &children[running])) {
+                printf("CreateProcess failed (%lu).\n", GetLastError());
+                return 1;
             }
-        } while (Process32NextW(hSnapshot, &pe));
+            ++launched;
+            ++running;
+        }
+        for (i = 0; i < running; ++i) {
+            handles[i] = children[i].process;
+        }
+
+        /* Returns the lowest signalled index; the short timeout leaves the
+           parent free to do its own work between exits */
+        result = WaitForMultipleObjects((DWORD)running, handles, FALSE, 1);
+        if (result == WAIT_TIMEOUT) {
+            ++workSlices;
+            continue;
+        }
+        if (result >= WAIT_OBJECT_0 + (DWORD)running) {
+            printf("WaitForMultipleObjects failed (%lu).\n", GetLastError());
+            return 1;
+        }
+
+        i = (int)(result - WAIT_OBJECT_0);
+        GetExitCodeProcess(children[i].process, &exitCode);
+        if (exitCode >= 0xC0000000UL) {
+            ++abnormal;  /* NTSTATUS failure code: the Windows "killed by signal" */
+        } else {
+            ++normal;
+        }
+        if (total <= 20) {
+            printf("Child %d (PID %lu) exited with code 0x%lX\n", children[i].tag, children[i].pid, exitCode);
+        }
+        CloseHandle(children[i].process);
+        children[i] = children[--running];  /* keep the array dense */
+        ++finished;
     }
-    CloseHandle(hSnapshot);
-    snprintf(name, size, "<Unknown>");
+
+    printf("Exited normally: %d, abnormally: %d, parent work slices: %llu, %lu ms\n",
+           normal, abnormal, workSlices, GetTickCount() - start);
+    return 0;
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     STARTUPINFO si;
     PROCESS_INFORMATION pi;
     DWORD parentPID = GetCurrentProcessId();
     char parentName[MAX_PATH], childName[MAX_PATH];
+    ProcessNameCache names;
+
+    if (argc > 1 && strcmp(argv[1], "supervise") == 0) {
+        int total = argc > 2 ? atoi(argv[2]) : 1000;
+        return total > 0 ? Supervise(total) : 1;
+    }
 
     ZeroMemory(&si, sizeof(si));
     si.cb = sizeof(si);
@@ -42,9 +126,17 @@ int main() {
         return 1;
     }
 
-    // Get process names
-    GetProcessNameByPID(parentPID, parentName, MAX_PATH);
-    GetProcessNameByPID(pi.dwProcessId, childName, MAX_PATH);
+    // Get process names: parent from one cached snapshot, child by handle
+    if (!ProcessNameCacheInit(&names)) {
+        printf("Process name cache allocation failed.\n");
+        TerminateProcess(pi.hProcess, 1);
+        CloseHandle(pi.hProcess);
+        CloseHandle(pi.hThread);
+        return 1;
+    }
+    ProcessNameCacheLookup(&names, parentPID, parentName, MAX_PATH);
+    ProcessNameCacheFromHandle(&names, pi.hProcess, pi.dwProcessId, childName, MAX_PATH);
+    ProcessNameCacheFree(&names);
 
     // Show results
     printf("Parent PID: %lu | Process Name: %s\n", parentPID, parentName);
@@ -1,7 +1,10 @@
 #include <windows.h>
 #include <tlhelp32.h>
 #include <stdio.h>
+#include "process_names.h"
+#include "batch_launcher.h"
 
+/* Uncached lookup: one full snapshot per call (kept as the benchmark baseline) */
 void GetProcessNameByPID(DWORD pid, char *name, size_t size) {
     HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
     PROCESSENTRY32W pe;  // wide-char version
@@ -20,62 +23,214 @@ void GetProcessNameByPID(DWORD pid, char *name, size_t size) {
     snprintf(name, size, "<Unknown>");
 }
 
-int main() {
-    STARTUPINFO si1, si2;
-    PROCESS_INFORMATION pi1, pi2;
-    DWORD parentPID = GetCurrentProcessId();
-    char parentName[MAX_PATH], child1Name[MAX_PATH], child2Name[MAX_PATH];
+static double Seconds(LARGE_INTEGER from, LARGE_INTEGER to) {
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    return (double)(to.QuadPart - from.QuadPart) / (double)freq.QuadPart;
+}
 
-    ZeroMemory(&si1, sizeof(si1));
-    si1.cb = sizeof(si1);
-    ZeroMemory(&pi1, sizeof(pi1));
+/*
+ * Lookups/sec with `count` extra processes alive: the per-call snapshot,
+ * the cached table, and direct QueryFullProcessImageNameW on held handles.
+ * The children are created suspended (cheap, and they stay alive until we
+ * terminate them).
+ */
+static int BenchmarkLookups(int count) {
+    PROCESS_INFORMATION *children = (PROCESS_INFORMATION *)calloc((size_t)count, sizeof(PROCESS_INFORMATION));
+    ProcessNameCache cache;
+    LARGE_INTEGER t0, t1;
+    char name[MAX_PATH];
+    char cmdLine[64];
+    int started = 0, i;
+    const int snapshotLookups = 200, cachedLookups = 1000000, handleLookups = 100000;
 
-    ZeroMemory(&si2, sizeof(si2));
-    si2.cb = sizeof(si2);
-    ZeroMemory(&pi2, sizeof(pi2));
+    if (children == NULL) {
+        return 1;
+    }
+    for (i = 0; i < count; ++i) {
+        STARTUPINFOA si;
+        ZeroMemory(&si, sizeof(si));
+        si.cb = sizeof(si);
+        snprintf(cmdLine, sizeof(cmdLine), "C:\\Windows\\System32\\cmd.exe /c exit 0");
+        if (!CreateProcessA(NULL, cmdLine, NULL, NULL, FALSE, CREATE_SUSPENDED | CREATE_NO_WINDOW,
+                            NULL, NULL, &si, &children[started])) {
+            printf("CreateProcess failed after %d children (%lu).\n", started, GetLastError());
+            break;
+        }
+        ++started;
+    }
+    if (started == 0) {
+        free(children);
+        return 1;
+    }
+    printf("Looking up names with %d extra processes running\n", started);
 
-    // Launch first child process
-    if (!CreateProcess(
-        "C:\\Windows\\System32\\notepad.exe",
-        NULL, NULL, NULL,
-        FALSE, 0, NULL, NULL,
-        &si1, &pi1))
-    {
-        printf("CreateProcess for child 1 failed (%lu).\n", GetLastError());
+    QueryPerformanceCounter(&t0);
+    for (i = 0; i < snapshotLookups; ++i) {
+        GetProcessNameByPID(children[i % started].dwProcessId, name, sizeof(name));
+    }
+    QueryPerformanceCounter(&t1);
+    printf("snapshot per lookup: %12.0f lookups/sec\n", snapshotLookups / Seconds(t0, t1));
+
+    QueryPerformanceCounter(&t0);
+    if (ProcessNameCacheInit(&cache)) {
+        for (i = 0; i < cachedLookups; ++i) {
+            ProcessNameCacheLookup(&cache, children[i % started].dwProcessId, name, sizeof(name));
+        }
+        QueryPerformanceCounter(&t1);
+        printf("cached table:        %12.0f lookups/sec (%lu snapshots, including the first)\n",
+               cachedLookups / Seconds(t0, t1), cache.snapshots);
+
+        QueryPerformanceCounter(&t0);
+        for (i = 0; i < handleLookups; ++i) {
+            PROCESS_INFORMATION *pi = &children[i % started];
+            ProcessNameCacheFromHandle(&cache, pi->hProcess, pi->dwProcessId, name, sizeof(name));
+        }
+        QueryPerformanceCounter(&t1);
+        printf("handle query:        %12.0f lookups/sec\n", handleLookups / Seconds(t0, t1));
+        ProcessNameCacheFree(&cache);
+    } else {
+        printf("Process name cache allocation failed.\n");
+    }
+
+    for (i = 0; i < started; ++i) {
+        TerminateProcess(children[i].hProcess, 0);
+        CloseHandle(children[i].hThread);
+        CloseHandle(children[i].hProcess);
+    }
+    free(children);
+    return 0;
+}
+
+/* Runs a manifest file through the batch launcher and prints per-child latency */
+static int LaunchManifest(const char *path, BOOL suspended) {
+    char **commands;
+    int count = BatchLoadManifest(path, &commands);
+    ProcessBatch batch;
+
+    if (count == 0) {
+        printf("No commands in manifest %s\n", path);
         return 1;
     }
+    if (!BatchLaunch(&batch, (const char *const *)commands, count, suspended ? BATCH_SUSPENDED : 0)) {
+        printf("Batch setup failed (%lu).\n", GetLastError());
+        BatchFreeManifest(commands, count);
+        return 1;
+    }
+    if (suspended) {
+        BatchResumeAll(&batch);
+    }
+    BatchWaitAll(&batch, INFINITE);
+    BatchReport(&batch, (const char *const *)commands);
+    BatchClose(&batch);
+    BatchFreeManifest(commands, count);
+    return 0;
+}
+
+/* Fan-out cost at N children: launch throughput, release, collective wait, teardown */
+static int BenchmarkFanOut(int count) {
+    const char **commands = (const char **)malloc(sizeof(char *) * (size_t)count);
+    ProcessBatch batch;
+    LARGE_INTEGER t0;
+    double createTotal = 0, createMax = 0, waitMs, closeMs;
+    int i;
 
-    // Launch second child process
-    if (!CreateProcess(
+    if (commands == NULL) {
+        return 1;
+    }
+    for (i = 0; i < count; ++i) {
+        commands[i] = "C:\\Windows\\System32\\cmd.exe /c exit 0";
+    }
+    if (!BatchLaunch(&batch, commands, count, BATCH_SUSPENDED)) {
+        printf("Batch setup failed (%lu).\n", GetLastError());
+        free(commands);
+        return 1;
+    }
+    BatchResumeAll(&batch);
+
+    QueryPerformanceCounter(&t0);
+    BatchWaitAll(&batch, INFINITE);
+    waitMs = BatchElapsedMs(t0);
+
+    for (i = 0; i < count; ++i) {
+        if (batch.children[i].started) {
+            createTotal += batch.children[i].createMs;
+            if (batch.children[i].createMs > createMax) {
+                createMax = batch.children[i].createMs;
+            }
+        }
+    }
+    printf("%d of %d children started in %.1f ms (%.0f launches/sec)\n", batch.started, count,
+           batch.launchMs, batch.started * 1000.0 / batch.launchMs);
+    printf("CreateProcess: mean %.3f ms, max %.3f ms\n",
+           batch.started ? createTotal / batch.started : 0.0, createMax);
+    printf("Resume all: %.3f ms, wait for all exits: %.1f ms\n", batch.resumeMs, waitMs);
+
+    QueryPerformanceCounter(&t0);
+    BatchClose(&batch);
+    closeMs = BatchElapsedMs(t0);
+    printf("Teardown (close %d process/thread handles and the job): %.3f ms\n", count, closeMs);
+    free(commands);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *const children[] = {
+        "C:\\Windows\\System32\\notepad.exe",
         "C:\\Windows\\System32\\calc.exe",
-        NULL, NULL, NULL,
-        FALSE, 0, NULL, NULL,
-        &si2, &pi2))
-    {
-        printf("CreateProcess for child 2 failed (%lu).\n", GetLastError());
+    };
+    DWORD parentPID = GetCurrentProcessId();
+    char parentName[MAX_PATH], child1Name[MAX_PATH], child2Name[MAX_PATH];
+    ProcessNameCache names;
+    ProcessBatch batch;
+    PROCESS_INFORMATION *pi1, *pi2;
+
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return BenchmarkLookups(argc > 2 ? atoi(argv[2]) : 500);
+    }
+    if (argc > 2 && strcmp(argv[1], "launch") == 0) {
+        return LaunchManifest(argv[2], argc > 3 && strcmp(argv[3], "suspended") == 0);
+    }
+    if (argc > 1 && strcmp(argv[1], "fanout") == 0) {
+        return BenchmarkFanOut(argc > 2 ? atoi(argv[2]) : 500);
+    }
+
+    // Launch both children as one batch (one Job Object)
+    if (!BatchLaunch(&batch, children, 2, 0)) {
+        printf("Batch setup failed (%lu).\n", GetLastError());
+        return 1;
+    }
+    if (batch.started != 2) {
+        printf("Starting child %d failed (%lu).\n",
+               batch.children[0].started ? 2 : 1,
+               batch.children[0].started ? batch.children[1].error : batch.children[0].error);
+        BatchClose(&batch);
         return 1;
     }
+    pi1 = &batch.children[0].pi;
+    pi2 = &batch.children[1].pi;
 
-    // Get process names
-    GetProcessNameByPID(parentPID, parentName, MAX_PATH);
-    GetProcessNameByPID(pi1.dwProcessId, child1Name, MAX_PATH);
-    GetProcessNameByPID(pi2.dwProcessId, child2Name, MAX_PATH);
+    // Get process names: one snapshot for the parent, the children by handle
+    if (!ProcessNameCacheInit(&names)) {
+        printf("Process name cache allocation failed.\n");
+        BatchClose(&batch);  /* closing the job kills both children */
+        return 1;
+    }
+    ProcessNameCacheLookup(&names, parentPID, parentName, MAX_PATH);
+    ProcessNameCacheFromHandle(&names, pi1->hProcess, pi1->dwProcessId, child1Name, MAX_PATH);
+    ProcessNameCacheFromHandle(&names, pi2->hProcess, pi2->dwProcessId, child2Name, MAX_PATH);
+    ProcessNameCacheFree(&names);
 
     // Show results
     printf("Parent PID: %lu | Process Name: %s\n", parentPID, parentName);
-    printf("Child1 PID: %lu | Process Name: %s\n", pi1.dwProcessId, child1Name);
-    printf("Child2 PID: %lu | Process Name: %s\n", pi2.dwProcessId, child2Name);
+    printf("Child1 PID: %lu | Process Name: %s\n", pi1->dwProcessId, child1Name);
+    printf("Child2 PID: %lu | Process Name: %s\n", pi2->dwProcessId, child2Name);
 
     // Wait for both children to finish (concurrently running)
-    WaitForSingleObject(pi1.hProcess, INFINITE);
-    WaitForSingleObject(pi2.hProcess, INFINITE);
+    BatchWaitAll(&batch, INFINITE);
 
-    // Close handles
-    CloseHandle(pi1.hProcess);
-    CloseHandle(pi1.hThread);
-    CloseHandle(pi2.hProcess);
-    CloseHandle(pi2.hThread);
+    // Close handles (and the job)
+    BatchClose(&batch);
 
     return 0;
 }
-
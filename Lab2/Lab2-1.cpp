@@ -1,7 +1,29 @@
 #include <iostream>
-#include <unistd.h>     // fork(), getpid(), getppid()
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <cstdint>
+#include <unordered_map>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <unistd.h>     // fork(), getpid(), getppid(), pipe()
 #include <sys/wait.h>   // wait()
 #include <sys/types.h>  // pid_t
+#include <sys/mman.h>   // mmap() for the shared result channel
+#include <sys/epoll.h>  // epoll_create1(), epoll_wait()
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
+#include "worker_pool.h"  // Task, WorkerPool, poolDemo(), benchmark()
+#include "result_ring.h"  // SharedResult, ResultRing
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434  // same number on every architecture that has it
+#endif
 
 using namespace std;
 
@@ -22,7 +44,7 @@ void demonstrateProcessConcepts() {
     cout << "==================================================" << endl;
 }
 
-int main() {
+int forkDemo() {
     demonstrateProcessConcepts();
 
     cout << "\n--- Before fork() ---" << endl;
@@ -95,3 +117,407 @@ int main() {
 
     return 0;
 }
+
+//=============================================================================
+// SUPERVISOR: NON-BLOCKING REAPING WITH AN EVENT LOOP
+//=============================================================================
+// wait() blocks the parent until some child dies. A supervisor instead gets a
+// file descriptor per child that becomes readable when the child exits
+// (pidfd_open, Linux 5.3+). It watches all of them with one epoll set, so the
+// parent can do its own work between exits and reap thousands of children as
+// they finish. Older kernels fall back to a single signalfd for SIGCHLD, and
+// each tracked child is then checked with waitpid(pid, WNOHANG).
+
+struct ChildOutcome {
+    pid_t pid;
+    int tag;       // caller's label for the child (e.g. task id)
+    bool exited;   // WIFEXITED; otherwise WIFSIGNALED
+    int code;      // exit code, or the signal number
+};
+
+class Supervisor {
+private:
+    int epoll_fd;
+    int signal_fd;                    // fallback only
+    bool use_pidfd;
+    sigset_t old_mask;
+    unordered_map<pid_t, int> tags;   // running children
+
+    static int pidfdOpen(pid_t pid) {
+        return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    }
+
+    void reaped(pid_t pid, int status, vector<ChildOutcome>& out) {
+        unordered_map<pid_t, int>::iterator it = tags.find(pid);
+        if (it == tags.end()) {
+            return;
+        }
+        ChildOutcome outcome = {pid, it->second, WIFEXITED(status) != 0,
+                                WIFEXITED(status) ? WEXITSTATUS(status) : WTERMSIG(status)};
+        out.push_back(outcome);
+        tags.erase(it);
+    }
+
+public:
+    Supervisor() : epoll_fd(epoll_create1(EPOLL_CLOEXEC)), signal_fd(-1), use_pidfd(false) {
+        int probe = pidfdOpen(getpid());
+        if (probe >= 0) {
+            close(probe);
+            use_pidfd = true;
+            return;
+        }
+        // SIGCHLD must be blocked before the first fork, or an early exit is lost
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &mask, &old_mask);
+        signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u64 = 0;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, signal_fd, &ev);
+    }
+
+    ~Supervisor() {
+        if (signal_fd >= 0) {
+            close(signal_fd);
+            sigprocmask(SIG_SETMASK, &old_mask, nullptr);
+        }
+        close(epoll_fd);
+    }
+
+    Supervisor(const Supervisor&) = delete;
+    Supervisor& operator=(const Supervisor&) = delete;
+
+    bool valid() const { return epoll_fd >= 0 && (use_pidfd || signal_fd >= 0); }
+    const char* mechanism() const { return use_pidfd ? "pidfd_open + epoll" : "signalfd(SIGCHLD) + epoll"; }
+    int running() const { return static_cast<int>(tags.size()); }
+
+    // Start watching a freshly forked child
+    bool watch(pid_t pid, int tag) {
+        tags[pid] = tag;
+        if (!use_pidfd) {
+            return true;
+        }
+        int pidfd = pidfdOpen(pid);  // still works if the child is already a zombie
+        if (pidfd < 0) {
+            return false;
+        }
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u64 = (static_cast<uint64_t>(pidfd) << 32) | static_cast<uint32_t>(pid);
+        return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pidfd, &ev) == 0;
+    }
+
+    // Waits up to `timeout_ms` (0 = just check) and appends every child that
+    // exited meanwhile to `out`. Returns the number reaped, or -1 on error.
+    int poll(int timeout_ms, vector<ChildOutcome>& out) {
+        const int MAX_EVENTS = 64;
+        epoll_event events[MAX_EVENTS];
+        int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout_ms);
+        if (ready < 0) {
+            return errno == EINTR ? 0 : -1;
+        }
+        size_t before = out.size();
+        for (int i = 0; i < ready; ++i) {
+            int status;
+            if (use_pidfd) {
+                pid_t pid = static_cast<pid_t>(events[i].data.u64 & 0xFFFFFFFFu);
+                int pidfd = static_cast<int>(events[i].data.u64 >> 32);
+                // Children forked later inherit this pidfd, so close() alone
+                // would leave it registered: remove it from the set explicitly
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pidfd, nullptr);
+                close(pidfd);
+                if (waitpid(pid, &status, 0) == pid) {  // already exited: returns at once
+                    reaped(pid, status, out);
+                }
+            } else {
+                signalfd_siginfo info;
+                while (read(signal_fd, &info, sizeof(info)) == sizeof(info)) {
+                }
+                // Signals coalesce, so check every child we track. Only our
+                // own PIDs: waitpid(-1) would also steal children started by
+                // other parts of the program.
+                // reaped() erases from tags, so collect first.
+                vector<pair<pid_t, int> > exited;
+                for (const auto& child : tags) {
+                    if (waitpid(child.first, &status, WNOHANG) == child.first) {
+                        exited.push_back(make_pair(child.first, status));
+                    }
+                }
+                for (const auto& e : exited) {
+                    reaped(e.first, e.second, out);
+                }
+            }
+        }
+        return static_cast<int>(out.size() - before);
+    }
+};
+
+// One unit of the parent's own work between polls (a few dozen microseconds)
+uint64_t parentWorkSlice(uint64_t seed) {
+    for (int i = 0; i < 20000; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    return seed;
+}
+
+// Runs `total` children, at most `max_running` at a time. Each sleeps a
+// little and then exits with its own code; every tenth kills itself with
+// SIGTERM, so both WIFEXITED and WIFSIGNALED outcomes show up.
+int superviseDemo(int total, int max_running) {
+    cout << "\n=== SUPERVISOR (" << total << " children, up to " << max_running << " at once) ===" << endl;
+    Supervisor supervisor;
+    if (!supervisor.valid()) {
+        cerr << "Supervisor setup failed: " << strerror(errno) << endl;
+        return 1;
+    }
+    cout << "Parent PID: " << getpid() << ", reaping via " << supervisor.mechanism() << endl;
+    cout.flush();
+
+    bool narrate = total <= 20;
+    int launched = 0, exited = 0, signaled = 0, peak = 0;
+    long long work_slices = 0;
+    uint64_t work = 1;
+    vector<ChildOutcome> outcomes;
+    auto start = chrono::steady_clock::now();
+
+    while (launched < total || supervisor.running() > 0) {
+        while (launched < total && supervisor.running() < max_running) {
+            int tag = launched++;
+            pid_t pid = fork();
+            if (pid < 0) {
+                cerr << "Fork failed!" << endl;
+                return 1;
+            }
+            if (pid == 0) {
+                usleep(static_cast<useconds_t>((tag * 37 % 50) * 1000));
+                if (tag % 10 == 9) {
+                    raise(SIGTERM);
+                }
+                _exit(tag % 100);
+            }
+            if (!supervisor.watch(pid, tag)) {
+                cerr << "Cannot watch child " << pid << ": " << strerror(errno) << endl;
+                return 1;
+            }
+        }
+        peak = max(peak, supervisor.running());
+
+        // The parent stays busy; exits are collected whenever they are ready
+        work = parentWorkSlice(work);
+        ++work_slices;
+
+        outcomes.clear();
+        if (supervisor.poll(0, outcomes) < 0) {
+            cerr << "epoll_wait failed: " << strerror(errno) << endl;
+            return 1;
+        }
+        for (const ChildOutcome& o : outcomes) {
+            if (o.exited) {
+                ++exited;
+            } else {
+                ++signaled;
+            }
+            if (narrate) {
+                cout << "Child " << o.tag << " (PID " << o.pid << ") "
+                     << (o.exited ? "exited normally with code: " : "terminated by signal: ")
+                     << o.code << endl;
+            }
+        }
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Exited normally: " << exited << ", terminated by signal: " << signaled
+         << ", peak concurrent: " << peak << endl;
+    cout << "Parent completed " << work_slices << " work slices in " << seconds
+         << " s while supervising (checksum " << (work & 0xFFFF) << ")" << endl;
+    return exited + signaled == total ? 0 : 1;
+}
+
+//=============================================================================
+// SHARED-MEMORY RESULT CHANNEL
+//=============================================================================
+// An exit code carries 8 bits, and the globalCounter demo shows why ordinary
+// writes never reach the parent: after fork() every page is copy-on-write.
+// A MAP_SHARED | MAP_ANONYMOUS mapping created before fork() is the
+// exception, because parent and children keep seeing the same physical pages.
+// Each child gets its own single-producer/single-consumer ring in that region
+// (ResultRing, from result_ring.h) and streams results into it directly: no
+// syscalls, no copy through a pipe.
+
+// Header padded to a cache line so the rings that follow it stay aligned
+struct alignas(64) SharedChannel {
+    atomic<long long> sharedCounter;  // the globalCounter that children *can* change
+    int rings;
+
+    ResultRing* ring(int i) { return reinterpret_cast<ResultRing*>(this + 1) + i; }
+
+    static size_t bytesFor(int rings) { return sizeof(SharedChannel) + rings * sizeof(ResultRing); }
+
+    // Maps a region shared with every child forked afterwards; nullptr on failure
+    static SharedChannel* create(int rings) {
+        void* memory = mmap(nullptr, bytesFor(rings), PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            return nullptr;
+        }
+        SharedChannel* channel = static_cast<SharedChannel*>(memory);
+        new (&channel->sharedCounter) atomic<long long>(0);
+        channel->rings = rings;
+        for (int i = 0; i < rings; ++i) {
+            new (channel->ring(i)) ResultRing();
+        }
+        return channel;
+    }
+
+    static void destroy(SharedChannel* channel) {
+        munmap(channel, bytesFor(channel->rings));
+    }
+};
+
+static_assert(sizeof(SharedChannel) % alignof(ResultRing) == 0, "rings must start aligned");
+
+int sharedChannelDemo(int children, int results) {
+    cout << "\n=== SHARED-MEMORY RESULT CHANNEL ===" << endl;
+    cout << children << " children x " << results << " results through per-child SPSC rings" << endl;
+
+    SharedChannel* channel = SharedChannel::create(children);
+    if (!channel) {
+        cerr << "mmap failed: " << strerror(errno) << endl;
+        return 1;
+    }
+    globalCounter = 0;
+    cout.flush();
+
+    vector<pid_t> pids;
+    auto start = chrono::steady_clock::now();
+    for (int c = 0; c < children; ++c) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            cerr << "Fork failed!" << endl;
+            break;
+        }
+        if (pid == 0) {
+            ResultRing* ring = channel->ring(c);
+            globalCounter += 1;                       // private copy: parent never sees it
+            channel->sharedCounter.fetch_add(1);      // shared page: parent sees it
+            for (int seq = 0; seq < results; ++seq) {
+                SharedResult r = {static_cast<uint32_t>(c), static_cast<uint32_t>(seq),
+                                  sharedResultValue(c, seq)};
+                while (!ring->push(r)) {
+                    this_thread::yield();             // parent is behind
+                }
+            }
+            ring->done.store(true, memory_order_release);
+            _exit(0);
+        }
+        pids.push_back(pid);
+    }
+
+    // Drain every ring round-robin until each child is done and empty. A child
+    // that dies early never sets `done`, so it is also reaped without blocking.
+    vector<uint32_t> expected(pids.size(), 0);
+    long long received = 0;
+    bool valid = true;
+    size_t finished = 0;
+    vector<bool> drained(pids.size(), false);
+    vector<bool> reaped(pids.size(), false);
+    while (finished < pids.size()) {
+        bool progress = false;
+        for (size_t c = 0; c < pids.size(); ++c) {
+            if (drained[c]) {
+                continue;
+            }
+            ResultRing* ring = channel->ring(static_cast<int>(c));
+            int status;
+            bool was_done = ring->done.load(memory_order_acquire);
+            if (!was_done && waitpid(pids[c], &status, WNOHANG) == pids[c]) {
+                reaped[c] = was_done = true;
+            }
+            SharedResult r;
+            while (ring->pop(r)) {
+                valid = valid && r.child == c && r.seq == expected[c]
+                        && r.value == sharedResultValue(r.child, r.seq);
+                ++expected[c];
+                ++received;
+                progress = true;
+            }
+            if (was_done) {  // no more pushes can follow, so the ring is now empty for good
+                drained[c] = true;
+                ++finished;
+            }
+        }
+        if (!progress) {
+            this_thread::yield();
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    // A child that failed to fork or died early leaves results missing
+    bool intact = valid && received == static_cast<long long>(children) * results;
+
+    for (size_t c = 0; c < pids.size(); ++c) {
+        int status;
+        if (!reaped[c]) {
+            waitpid(pids[c], &status, 0);
+        }
+    }
+
+    cout << "Received " << received << " results in " << seconds << " s ("
+         << static_cast<long long>(received / seconds) << " results/sec), "
+         << (intact ? "all in order and intact" : "CORRUPTED")
+         << endl;
+    cout << "Parent's globalCounter: " << globalCounter
+         << " (children incremented private copy-on-write pages)" << endl;
+    cout << "Shared counter: " << channel->sharedCounter.load()
+         << " (one increment per child, visible through MAP_SHARED)" << endl;
+    SharedChannel::destroy(channel);
+    return intact ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--pool") {
+        return poolDemo(argc > 2 ? atoi(argv[2]) : 8, argc > 3 ? atoi(argv[3]) : 3);
+    }
+    if (mode == "--shared") {
+        int children = argc > 2 ? atoi(argv[2]) : 4;
+        int results = argc > 3 ? atoi(argv[3]) : 1000000;
+        if (children <= 0 || results <= 0) {
+            cerr << "usage: " << argv[0] << " --shared [CHILDREN] [RESULTS_PER_CHILD]" << endl;
+            return 2;
+        }
+        return sharedChannelDemo(children, results);
+    }
+    if (mode == "--supervise") {
+        int total = argc > 2 ? atoi(argv[2]) : 1000;
+        int max_running = argc > 3 ? atoi(argv[3]) : 128;
+        if (total <= 0 || max_running <= 0) {
+            cerr << "usage: " << argv[0] << " --supervise [CHILDREN] [MAX_RUNNING]" << endl;
+            return 2;
+        }
+        return superviseDemo(total, max_running);
+    }
+    if (mode == "--bench") {
+        int tasks = argc > 2 ? atoi(argv[2]) : 20000;
+        int workers = argc > 3 ? atoi(argv[3]) : 4;
+        int work_us = argc > 4 ? atoi(argv[4]) : 0;
+        if (tasks <= 0 || workers <= 0 || work_us < 0) {
+            cerr << "usage: " << argv[0] << " [--pool [TASKS] [WORKERS] | --bench [TASKS] [WORKERS] [WORK_US]]" << endl;
+            return 2;
+        }
+        return benchmark(tasks, workers, work_us);
+    }
+    return forkDemo();
+}
+
+/*
+Build:  g++ -std=c++11 -O2 Lab2-1.cpp -o lab2-1
+Run:    ./lab2-1                      original fork()/wait() demo
+        ./lab2-1 --pool 8 3           8 tasks through 3 pre-forked workers
+        ./lab2-1 --bench 20000 4 0    tasks/sec, fork-per-task vs worker pool
+        ./lab2-1 --supervise 1000 128 1000 children reaped through pidfd/epoll
+                                      while the parent keeps working
+        ./lab2-1 --shared 4 1000000   children stream results to the parent through
+                                      per-child SPSC rings in a MAP_SHARED region
+*/
@@ -0,0 +1,64 @@
+/*
+ * result_ring.h - shared-memory result ring shared by Lab2-1.cpp and Lab3-1.cpp
+ *
+ * Each child streams results into its own single-producer/single-consumer
+ * ring inside memory the parent also maps (a MAP_SHARED mapping on Linux, a
+ * named file mapping on Windows); how that memory is obtained stays in each
+ * program's SharedChannel. std::atomic on lock-free types is address-free, so
+ * it works across processes that map the same memory, even at different
+ * addresses.
+ */
+#ifndef RESULT_RING_H
+#define RESULT_RING_H
+
+#include <atomic>
+#include <cstdint>
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "shared-memory rings need lock-free atomics");
+
+struct SharedResult {
+    uint32_t child;
+    uint32_t seq;
+    uint64_t value;
+};
+
+struct ResultRing {
+    static const uint32_t CAPACITY = 4096;  // power of two
+
+    alignas(64) std::atomic<uint32_t> head;   // next slot the parent reads
+    alignas(64) std::atomic<uint32_t> tail;   // next slot the child writes
+    std::atomic<bool> done;                   // child has produced everything
+    alignas(64) SharedResult slots[CAPACITY];
+
+    ResultRing() : head(0), tail(0), done(false) {}
+
+    // Producer side (the child); false when the ring is full
+    bool push(const SharedResult& r) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == CAPACITY) {
+            return false;
+        }
+        slots[t & (CAPACITY - 1)] = r;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side (the parent); false when the ring is empty
+    bool pop(SharedResult& r) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        r = slots[h & (CAPACITY - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// What child `child` reports for its `seq`-th result (the parent re-derives it)
+inline uint64_t sharedResultValue(uint32_t child, uint32_t seq) {
+    return static_cast<uint64_t>(seq) * seq + child;
+}
+
+#endif // RESULT_RING_H
@@ -0,0 +1,322 @@
+/*
+ * worker_pool.h - pre-forked worker pool shared by Lab2-1.cpp and Lab3-1-linux.cpp
+ *
+ * Fork-per-task pays for fork(), the page-table copy and exit() on every unit
+ * of work. A pool forks its workers once; each one reads tasks from its own
+ * pipe and writes a result record (the exit code it would have returned) to a
+ * shared result pipe instead of dying. Records are smaller than PIPE_BUF, so
+ * writes from different workers never interleave. The parent ignores SIGPIPE,
+ * so writing to a worker that has died fails with EPIPE instead of killing it;
+ * submitAny() then hands the task to a live worker. poolDemo() and benchmark()
+ * back both programs' --pool and --bench modes.
+ */
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <csignal>      // signal(), SIGPIPE
+#include <unistd.h>     // fork(), pipe(), read(), write()
+#include <sys/wait.h>   // wait(), waitpid()
+#include <sys/types.h>  // pid_t
+
+// One unit of work: burn `work_us` microseconds of CPU, then "exit" with a code
+struct Task {
+    int id;
+    int work_us;
+};
+
+// What wait() would have told us about a fork-per-task child
+struct TaskResult {
+    int id;
+    int worker;
+    pid_t pid;
+    int exit_code;
+};
+
+// The work itself; the exit code reuses the demo's 42 plus the task id
+inline int runTask(const Task& task) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(task.work_us);
+    while (std::chrono::steady_clock::now() < until) {
+    }
+    return (42 + task.id) & 0xFF;
+}
+
+// read()/write() the whole record, retrying on EINTR and short transfers.
+// Returns false on EOF or error.
+inline bool readFull(int fd, void* buffer, size_t size) {
+    char* p = static_cast<char*>(buffer);
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+inline bool writeFull(int fd, const void* buffer, size_t size) {
+    const char* p = static_cast<const char*>(buffer);
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+class WorkerPool {
+private:
+    struct Worker {
+        pid_t pid;
+        int task_fd;   // parent's write end of this worker's task pipe
+        bool alive;    // false once a submit() to it has failed
+    };
+
+    std::vector<Worker> workers;
+    int result_fd;     // parent's read end of the shared result pipe
+
+    // Child side: serve tasks until the parent closes our task pipe
+    static void workerLoop(int index, int task_fd, int result_fd) {
+        Task task;
+        while (readFull(task_fd, &task, sizeof(task))) {
+            TaskResult result = {task.id, index, getpid(), runTask(task)};
+            if (!writeFull(result_fd, &result, sizeof(result))) {
+                break;
+            }
+        }
+        _exit(0);
+    }
+
+public:
+    explicit WorkerPool(int count) : result_fd(-1) {
+        int result_pipe[2];
+        if (pipe(result_pipe) < 0) {
+            std::cerr << "pipe failed: " << strerror(errno) << std::endl;
+            return;
+        }
+        std::cout.flush();  // don't let children inherit (and repeat) buffered output
+
+        for (int i = 0; i < count; ++i) {
+            int task_pipe[2];
+            if (pipe(task_pipe) < 0) {
+                std::cerr << "pipe failed: " << strerror(errno) << std::endl;
+                break;
+            }
+            pid_t pid = fork();
+            if (pid < 0) {
+                std::cerr << "Fork failed!" << std::endl;
+                close(task_pipe[0]);
+                close(task_pipe[1]);
+                break;
+            }
+            if (pid == 0) {
+                // Keep only our task pipe and the result pipe's write end
+                for (const Worker& w : workers) {
+                    close(w.task_fd);
+                }
+                close(task_pipe[1]);
+                close(result_pipe[0]);
+                workerLoop(i, task_pipe[0], result_pipe[1]);
+            }
+            close(task_pipe[0]);
+            Worker w = {pid, task_pipe[1], true};
+            workers.push_back(w);
+        }
+        // Workers keep the default action and die if the parent goes away;
+        // the parent must survive a dead worker's closed task pipe
+        signal(SIGPIPE, SIG_IGN);
+        close(result_pipe[1]);
+        result_fd = result_pipe[0];
+    }
+
+    ~WorkerPool() { shutdown(); }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    // Fails (and marks the worker dead) if the worker has exited
+    bool submit(int worker, const Task& task) {
+        Worker& w = workers[worker];
+        if (w.alive && !writeFull(w.task_fd, &task, sizeof(task))) {
+            std::cerr << "Worker " << worker << " (PID " << w.pid << ") is gone: "
+                      << strerror(errno) << std::endl;
+            w.alive = false;
+        }
+        return w.alive;
+    }
+
+    // Submits to `preferred`, or else to the next live worker; returns the
+    // worker that took the task, or -1 once every worker is dead
+    int submitAny(int preferred, const Task& task) {
+        for (int i = 0; i < size(); ++i) {
+            int worker = (preferred + i) % size();
+            if (submit(worker, task)) {
+                return worker;
+            }
+        }
+        return -1;
+    }
+
+    // Blocks until any worker reports a finished task
+    bool collect(TaskResult& result) {
+        return readFull(result_fd, &result, sizeof(result));
+    }
+
+    // Close every task pipe (workers see EOF and exit), then reap them
+    void shutdown() {
+        for (const Worker& w : workers) {
+            close(w.task_fd);
+        }
+        for (const Worker& w : workers) {
+            int status;
+            waitpid(w.pid, &status, 0);
+        }
+        workers.clear();
+        if (result_fd >= 0) {
+            close(result_fd);
+            result_fd = -1;
+        }
+    }
+};
+
+// Fork-per-task with up to `parallel` children alive: fork, child runs the
+// task and exits with its code, parent wait()s for any child and forks again
+inline long long runForkPerTask(int tasks, int parallel, int work_us) {
+    long long checksum = 0;
+    int next = 0;
+    int running = 0;
+    std::cout.flush();
+    while (next < tasks || running > 0) {
+        while (next < tasks && running < parallel) {
+            Task task = {next++, work_us};
+            pid_t pid = fork();
+            if (pid < 0) {
+                std::cerr << "Fork failed!" << std::endl;
+                return -1;
+            }
+            if (pid == 0) {
+                _exit(runTask(task));
+            }
+            ++running;
+        }
+        int status;
+        if (wait(&status) < 0) {
+            return -1;
+        }
+        --running;
+        if (WIFEXITED(status)) {
+            checksum += WEXITSTATUS(status);
+        }
+    }
+    return checksum;
+}
+
+// The same tasks through a pool; each worker always has one task in flight
+inline long long runPool(WorkerPool& pool, int tasks, int work_us) {
+    long long checksum = 0;
+    int next = 0;
+    int outstanding = 0;
+    for (int w = 0; w < pool.size() && next < tasks; ++w, ++outstanding) {
+        Task task = {next++, work_us};
+        if (pool.submitAny(w, task) < 0) {
+            return -1;
+        }
+    }
+    while (outstanding > 0) {
+        TaskResult result;
+        if (!pool.collect(result)) {
+            return -1;
+        }
+        --outstanding;
+        checksum += result.exit_code;
+        if (next < tasks) {
+            Task task = {next++, work_us};
+            if (pool.submitAny(result.worker, task) < 0) {
+                return -1;
+            }
+            ++outstanding;
+        }
+    }
+    return checksum;
+}
+
+// Small narrated run: the pool version of the demo above
+inline int poolDemo(int tasks, int workers) {
+    std::cout << "\n=== PRE-FORKED WORKER POOL ===" << std::endl;
+    std::cout << "Parent PID: " << getpid() << ", forking " << workers << " workers once" << std::endl;
+
+    WorkerPool pool(workers);
+    if (pool.size() == 0) {
+        return 1;
+    }
+    int next = 0;
+    int outstanding = 0;
+    for (int w = 0; w < pool.size() && next < tasks; ++w, ++outstanding) {
+        Task task = {next++, 1000};
+        if (pool.submitAny(w, task) < 0) {
+            std::cerr << "Worker pool lost its workers!" << std::endl;
+            return 1;
+        }
+    }
+    while (outstanding > 0) {
+        TaskResult result;
+        if (!pool.collect(result)) {
+            std::cerr << "Worker pool lost its workers!" << std::endl;
+            return 1;
+        }
+        --outstanding;
+        std::cout << "Task " << result.id << " finished by worker " << result.worker
+             << " (PID " << result.pid << ") with code: " << result.exit_code << std::endl;
+        if (next < tasks) {
+            Task task = {next++, 1000};
+            if (pool.submitAny(result.worker, task) < 0) {
+                std::cerr << "Worker pool lost its workers!" << std::endl;
+                return 1;
+            }
+            ++outstanding;
+        }
+    }
+    pool.shutdown();
+    std::cout << "All workers exited; " << tasks << " tasks used " << workers << " fork() calls" << std::endl;
+    return 0;
+}
+
+// tasks/sec for fork-per-task vs the pool at the same parallelism
+inline int benchmark(int tasks, int workers, int work_us) {
+    std::cout << "\n=== FORK-PER-TASK vs WORKER POOL ===" << std::endl;
+    std::cout << tasks << " tasks, " << workers << " in parallel, "
+         << work_us << " us of work each" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    long long fork_sum = runForkPerTask(tasks, workers, work_us);
+    double fork_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    long long pool_sum;
+    {
+        WorkerPool pool(workers);
+        pool_sum = pool.size() > 0 ? runPool(pool, tasks, work_us) : -1;
+    }
+    double pool_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (fork_sum < 0 || pool_sum < 0 || fork_sum != pool_sum) {
+        std::cerr << "Result mismatch: fork-per-task " << fork_sum << ", pool " << pool_sum << std::endl;
+        return 1;
+    }
+    std::cout << "fork-per-task: " << static_cast<long long>(tasks / fork_seconds) << " tasks/sec" << std::endl;
+    std::cout << "worker pool:   " << static_cast<long long>(tasks / pool_seconds) << " tasks/sec"
+         << " (includes forking and reaping the pool)" << std::endl;
+    std::cout << "speedup:       " << fork_seconds / pool_seconds << "x" << std::endl;
+    return 0;
+}
+
+#endif /* WORKER_POOL_H */
@@ -1,7 +1,22 @@
 #include <iostream>
-#include <unistd.h>     // fork(), getpid(), getppid()
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>     // fork(), vfork(), getpid(), getppid(), pipe()
 #include <sys/wait.h>   // wait()
 #include <sys/types.h>  // pid_t
+#include <sys/mman.h>   // mmap() for the clone() child stack
+#include <sched.h>      // clone()
+#include <spawn.h>      // posix_spawn()
+#include <csignal>      // SIGCHLD
+#include "../Lab2/worker_pool.h"  // Task, WorkerPool, poolDemo(), benchmark()
+
+extern char** environ;
 
 using namespace std;
 
@@ -22,7 +37,7 @@ void demonstrateProcessConcepts() {
     cout << "==================================================" << endl;
 }
 
-int main() {
+int forkDemo() {
     demonstrateProcessConcepts();
 
     cout << "\n--- Before fork() ---" << endl;
@@ -94,4 +109,243 @@ int main() {
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+//=============================================================================
+// SPAWN BACKENDS (fork / vfork / clone / posix_spawn)
+//=============================================================================
+// fork() duplicates the parent's page tables (copy-on-write), so its cost grows
+// with the parent's resident memory. The other backends share the parent's
+// address space until the child calls exec(), which makes them cost about the
+// same at 1 MB and at 1 GB. Every backend runs the same child program and
+// reports its exit status through waitpid().
+
+enum SpawnBackend { SPAWN_FORK, SPAWN_VFORK, SPAWN_CLONE, SPAWN_POSIX, SPAWN_BACKENDS };
+
+const char* const SPAWN_NAMES[SPAWN_BACKENDS] = {"fork", "vfork", "clone", "posix_spawn"};
+
+bool parseBackend(const string& name, SpawnBackend& out) {
+    for (int b = 0; b < SPAWN_BACKENDS; ++b) {
+        if (name == SPAWN_NAMES[b]) {
+            out = static_cast<SpawnBackend>(b);
+            return true;
+        }
+    }
+    return false;
+}
+
+struct ExecTarget {
+    const char* path;
+    char* const* argv;
+};
+
+int execChild(void* arg) {
+    const ExecTarget* target = static_cast<const ExecTarget*>(arg);
+    execv(target->path, target->argv);
+    _exit(127);  // exec failed; only async-signal-safe calls are allowed here
+}
+
+// Starts `path argv...` with the chosen backend. Returns the child's PID, or
+// -1 with errno set for every backend (callers report strerror(errno)).
+pid_t spawnChild(SpawnBackend backend, const char* path, char* const argv[]) {
+    ExecTarget target = {path, argv};
+    pid_t pid = -1;
+    switch (backend) {
+    case SPAWN_FORK:
+        pid = fork();
+        if (pid == 0) {
+            execChild(&target);
+        }
+        break;
+    case SPAWN_VFORK:
+        // The parent is suspended until the child execs or exits
+        pid = vfork();
+        if (pid == 0) {
+            execChild(&target);
+        }
+        break;
+    case SPAWN_CLONE: {
+        // vfork() spelled out: share the address space, suspend the parent
+        // until exec, and deliver SIGCHLD so waitpid() works as usual.
+        // The child only needs a small private stack until it execs.
+        static const size_t STACK_SIZE = 64 * 1024;
+        static void* stack = MAP_FAILED;
+        if (stack == MAP_FAILED) {
+            stack = mmap(nullptr, STACK_SIZE, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+            if (stack == MAP_FAILED) {
+                return -1;
+            }
+        }
+        pid = clone(execChild, static_cast<char*>(stack) + STACK_SIZE,
+                    CLONE_VM | CLONE_VFORK | SIGCHLD, &target);
+        break;
+    }
+    case SPAWN_POSIX: {
+        // posix_spawn() returns its error instead of setting errno
+        int rc = posix_spawn(&pid, path, nullptr, nullptr, argv, environ);
+        if (rc != 0) {
+            errno = rc;
+            pid = -1;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return pid;
+}
+
+// Spawns this program again in --child mode and collects its exit code
+int spawnDemo(SpawnBackend backend, const char* self) {
+    cout << "\n=== SPAWNING WITH " << SPAWN_NAMES[backend] << " ===" << endl;
+    cout << "Parent PID: " << getpid() << endl;
+    cout.flush();
+
+    char child_flag[] = "--child";
+    char* child_argv[] = {const_cast<char*>(self), child_flag, nullptr};
+    pid_t pid = spawnChild(backend, self, child_argv);
+    if (pid < 0) {
+        cerr << SPAWN_NAMES[backend] << " failed: " << strerror(errno) << endl;
+        return 1;
+    }
+    cout << "Created Child PID: " << pid << endl;
+
+    int status;
+    waitpid(pid, &status, 0);
+    if (WIFEXITED(status)) {
+        cout << "Child exited normally with code: " << WEXITSTATUS(status) << endl;
+    } else if (WIFSIGNALED(status)) {
+        cout << "Child terminated by signal: " << WTERMSIG(status) << endl;
+    }
+    return 0;
+}
+
+long residentMegabytes() {
+    long pages = 0, resident = 0;
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm) {
+        if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        fclose(statm);
+    }
+    return resident * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+}
+
+// Mean microseconds per spawn, from the spawn call until the child is reaped
+double measureSpawn(SpawnBackend backend, const char* path, int iterations) {
+    char* child_argv[] = {const_cast<char*>(path), nullptr};
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        pid_t pid = spawnChild(backend, path, child_argv);
+        if (pid < 0) {
+            return -1;
+        }
+        int status;
+        waitpid(pid, &status, 0);
+    }
+    chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+// Grows the parent's resident memory step by step (touching every page so it
+// is really resident) and times each backend at every size
+int spawnBenchmark(const vector<SpawnBackend>& backends, long max_mb, int iterations, const char* path) {
+    cout << "\n=== SPAWN LATENCY vs PARENT RSS (" << path << ", "
+         << iterations << " spawns per cell, us per spawn+wait) ===" << endl;
+    cout << setw(10) << "RSS MB";
+    for (SpawnBackend b : backends) {
+        cout << setw(14) << SPAWN_NAMES[b];
+    }
+    cout << endl;
+
+    vector<char*> ballast;
+    long allocated_mb = 0;
+    for (long target_mb = 1; target_mb <= max_mb; target_mb *= 4) {
+        while (allocated_mb < target_mb) {
+            const size_t CHUNK = 1024 * 1024;
+            char* chunk = static_cast<char*>(malloc(CHUNK));
+            if (!chunk) {
+                cerr << "out of memory at " << allocated_mb << " MB" << endl;
+                max_mb = 0;
+                break;
+            }
+            memset(chunk, 1, CHUNK);
+            ballast.push_back(chunk);
+            ++allocated_mb;
+        }
+        cout << setw(10) << residentMegabytes() << fixed << setprecision(1);
+        for (SpawnBackend b : backends) {
+            cout << setw(14) << measureSpawn(b, path, iterations);
+        }
+        cout << endl;
+    }
+    for (char* chunk : ballast) {
+        free(chunk);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--child") {
+        return 42;  // what the spawned child of --spawn reports back
+    }
+    if (mode == "--spawn") {
+        SpawnBackend backend = SPAWN_FORK;
+        if (argc > 2 && !parseBackend(argv[2], backend)) {
+            cerr << "unknown backend: " << argv[2] << " (fork, vfork, clone, posix_spawn)" << endl;
+            return 2;
+        }
+        return spawnDemo(backend, "/proc/self/exe");
+    }
+    if (mode == "--spawn-bench") {
+        vector<SpawnBackend> backends;
+        SpawnBackend backend;
+        if (argc > 2 && string(argv[2]) != "all") {
+            if (!parseBackend(argv[2], backend)) {
+                cerr << "unknown backend: " << argv[2] << " (fork, vfork, clone, posix_spawn, all)" << endl;
+                return 2;
+            }
+            backends.push_back(backend);
+        } else {
+            for (int b = 0; b < SPAWN_BACKENDS; ++b) {
+                backends.push_back(static_cast<SpawnBackend>(b));
+            }
+        }
+        long max_mb = argc > 3 ? atol(argv[3]) : 1024;
+        int iterations = argc > 4 ? atoi(argv[4]) : 200;
+        const char* path = argc > 5 ? argv[5] : "/bin/true";
+        if (max_mb <= 0 || iterations <= 0) {
+            cerr << "usage: " << argv[0] << " --spawn-bench [BACKEND|all] [MAX_MB] [ITERATIONS] [PROGRAM]" << endl;
+            return 2;
+        }
+        return spawnBenchmark(backends, max_mb, iterations, path);
+    }
+    if (mode == "--pool") {
+        return poolDemo(argc > 2 ? atoi(argv[2]) : 8, argc > 3 ? atoi(argv[3]) : 3);
+    }
+    if (mode == "--bench") {
+        int tasks = argc > 2 ? atoi(argv[2]) : 20000;
+        int workers = argc > 3 ? atoi(argv[3]) : 4;
+        int work_us = argc > 4 ? atoi(argv[4]) : 0;
+        if (tasks <= 0 || workers <= 0 || work_us < 0) {
+            cerr << "usage: " << argv[0] << " [--pool [TASKS] [WORKERS] | --bench [TASKS] [WORKERS] [WORK_US]]" << endl;
+            return 2;
+        }
+        return benchmark(tasks, workers, work_us);
+    }
+    return forkDemo();
+}
+
+/*
+Build:  g++ -std=c++11 -O2 Lab3-1-linux.cpp -o lab3-1
+Run:    ./lab3-1                      original fork()/wait() demo
+        ./lab3-1 --pool 8 3           8 tasks through 3 pre-forked workers
+        ./lab3-1 --bench 20000 4 0    tasks/sec, fork-per-task vs worker pool
+        ./lab3-1 --spawn vfork        spawn a child with fork | vfork | clone | posix_spawn
+        ./lab3-1 --spawn-bench all 1024 200
+                                      spawn latency per backend as the parent's RSS
+                                      grows 1, 4, 16, ... up to 1024 MB (child: /bin/true)
+*/
\ No newline at end of file
@@ -1,5 +1,14 @@
 #include <iostream>
+#include <string>
+#include <unordered_map>
+#include <cstdlib>
+#include <cstdint>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
 #include <windows.h>
+#include "../Lab2/result_ring.h"  // SharedResult, ResultRing
 
 using namespace std;
 
@@ -48,12 +57,313 @@ void parentProcess(PROCESS_INFORMATION pi) {
     cout << "Parent: All done!" << endl;
 }
 
+// Supervisor mode: many children at once, reaped as they exit. Every child is
+// created suspended, put in one Job Object and then resumed; the job posts
+// JOB_OBJECT_MSG_EXIT_PROCESS to an IO completion port whenever a member
+// exits. One GetQueuedCompletionStatus loop can therefore follow thousands of
+// children (WaitForMultipleObjects stops at 64 handles), and the parent keeps
+// working between messages.
+struct SupervisedChild {
+    HANDLE process;
+    int tag;
+};
+
+bool startSupervisedChild(const string& exePath, int tag, HANDLE job,
+                          unordered_map<DWORD, SupervisedChild>& running) {
+    // Every tenth child fails with an NTSTATUS code, the Windows stand-in
+    // for a Unix child killed by a signal
+    unsigned long code = (tag % 10 == 9) ? 0xC000013AUL : static_cast<unsigned long>(tag % 100);
+    string cmdLine = "\"" + exePath + "\" child-exit " + to_string(code);
+
+    STARTUPINFOA si;
+    PROCESS_INFORMATION pi;
+    ZeroMemory(&si, sizeof(si));
+    si.cb = sizeof(si);
+    ZeroMemory(&pi, sizeof(pi));
+    if (!CreateProcessA(NULL, &cmdLine[0], NULL, NULL, FALSE, CREATE_SUSPENDED,
+                        NULL, NULL, &si, &pi)) {
+        return false;
+    }
+    // Record the child before it can run, so its exit message always finds it
+    SupervisedChild child = {pi.hProcess, tag};
+    running[pi.dwProcessId] = child;
+    if (!AssignProcessToJobObject(job, pi.hProcess)) {
+        // Outside the job its exit would never reach the port; it has not
+        // run yet, so kill it rather than supervise it some other way
+        DWORD error = GetLastError();
+        running.erase(pi.dwProcessId);
+        TerminateProcess(pi.hProcess, 1);
+        CloseHandle(pi.hThread);
+        CloseHandle(pi.hProcess);
+        SetLastError(error);
+        return false;
+    }
+    ResumeThread(pi.hThread);
+    CloseHandle(pi.hThread);
+    return true;
+}
+
+int superviseChildren(int total, int maxRunning) {
+    cout << "\n=== SUPERVISOR (" << total << " children, up to " << maxRunning << " at once) ===" << endl;
+    cout << "Parent PID: " << GetCurrentProcessId() << ", reaping via Job Object + IO completion port" << endl;
+
+    char exePath[MAX_PATH];
+    GetModuleFileNameA(NULL, exePath, MAX_PATH);
+
+    HANDLE port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    HANDLE job = CreateJobObjectA(NULL, NULL);
+    if (port == NULL || job == NULL) {
+        cerr << "Job/port setup failed: " << GetLastError() << endl;
+        return 1;
+    }
+    JOBOBJECT_ASSOCIATE_COMPLETION_PORT association;
+    association.CompletionKey = job;
+    association.CompletionPort = port;
+    if (!SetInformationJobObject(job, JobObjectAssociateCompletionPortInformation,
+                                 &association, sizeof(association))) {
+        cerr << "SetInformationJobObject failed: " << GetLastError() << endl;
+        return 1;
+    }
+
+    unordered_map<DWORD, SupervisedChild> running;
+    int launched = 0, finished = 0, normal = 0, abnormal = 0;
+    unsigned long long workSlices = 0;
+    ULONGLONG start = GetTickCount64();
+    ULONGLONG lastSweep = start;
+
+    // Counts one exited child and forgets it
+    auto reap = [&](unordered_map<DWORD, SupervisedChild>::iterator it) {
+        DWORD exitCode = 0;
+        GetExitCodeProcess(it->second.process, &exitCode);
+        if (exitCode >= 0xC0000000UL) {
+            ++abnormal;
+        } else {
+            ++normal;
+        }
+        if (total <= 20) {
+            cout << "Child " << it->second.tag << " (PID " << it->first << ") exited with status " << exitCode << endl;
+        }
+        CloseHandle(it->second.process);
+        ++finished;
+        return running.erase(it);
+    };
+
+    while (finished < total) {
+        while (launched < total && static_cast<int>(running.size()) < maxRunning) {
+            if (!startSupervisedChild(exePath, launched, job, running)) {
+                cerr << "Starting child " << launched << " failed: " << GetLastError() << endl;
+                return 1;
+            }
+            ++launched;
+        }
+
+        DWORD message;
+        ULONG_PTR key;
+        LPOVERLAPPED overlapped;
+        // Short timeout: no exit pending means the parent does its own work
+        if (!GetQueuedCompletionStatus(port, &message, &key, &overlapped, 1)) {
+            ++workSlices;
+            // Job notifications are not guaranteed to be delivered, so every
+            // 50 ms check the handles themselves; a lost message then costs a
+            // short delay instead of hanging the parent
+            ULONGLONG now = GetTickCount64();
+            if (now - lastSweep >= 50) {
+                lastSweep = now;
+                for (auto it = running.begin(); it != running.end();) {
+                    if (WaitForSingleObject(it->second.process, 0) == WAIT_OBJECT_0) {
+                        it = reap(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+            continue;
+        }
+        if (message != JOB_OBJECT_MSG_EXIT_PROCESS && message != JOB_OBJECT_MSG_ABNORMAL_EXIT_PROCESS) {
+            continue;  // e.g. JOB_OBJECT_MSG_NEW_PROCESS
+        }
+
+        // For job messages the "overlapped" pointer carries the process ID.
+        // A child the sweep already reaped is no longer in `running`.
+        DWORD pid = static_cast<DWORD>(reinterpret_cast<ULONG_PTR>(overlapped));
+        unordered_map<DWORD, SupervisedChild>::iterator it = running.find(pid);
+        if (it != running.end()) {
+            reap(it);
+        }
+    }
+
+    cout << "Exited normally: " << normal << ", abnormally: " << abnormal
+         << ", parent work slices: " << workSlices
+         << ", " << (GetTickCount64() - start) << " ms" << endl;
+    CloseHandle(job);
+    CloseHandle(port);
+    return 0;
+}
+
+// Shared-memory result channel. An exit code is one number, and a child's
+// ordinary writes stay in its own address space. A named file mapping backed
+// by the paging file is visible to every process that opens the name, so the
+// parent creates one and each child maps it and streams results into its own
+// single-producer/single-consumer ring (the ResultRing Lab2-1.cpp uses),
+// without pipes or extra copies.
+
+// Header padded to a cache line so the rings that follow it stay aligned
+struct alignas(64) SharedChannel {
+    int rings;
+
+    ResultRing* ring(int i) { return reinterpret_cast<ResultRing*>(this + 1) + i; }
+    static size_t bytesFor(int rings) { return sizeof(SharedChannel) + rings * sizeof(ResultRing); }
+};
+
+// Child side: open the parent's mapping by name and fill ring `index`
+int sharedChild(const char* name, int index, int results) {
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+    if (mapping == NULL) {
+        return 1;
+    }
+    SharedChannel* channel = static_cast<SharedChannel*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+    if (channel == NULL) {
+        CloseHandle(mapping);
+        return 1;
+    }
+    ResultRing* ring = channel->ring(index);
+    for (int seq = 0; seq < results; ++seq) {
+        SharedResult r = {static_cast<uint32_t>(index), static_cast<uint32_t>(seq),
+                          sharedResultValue(index, seq)};
+        while (!ring->push(r)) {
+            std::this_thread::yield();  // parent is behind
+        }
+    }
+    ring->done.store(true, std::memory_order_release);
+    UnmapViewOfFile(channel);
+    CloseHandle(mapping);
+    return 0;
+}
+
+int sharedChannelDemo(int children, int results) {
+    cout << "\n=== SHARED-MEMORY RESULT CHANNEL ===" << endl;
+    cout << children << " children x " << results << " results through per-child SPSC rings" << endl;
+
+    string name = "Local\\Lab3-1-results-" + to_string(GetCurrentProcessId());
+    unsigned long long bytes = SharedChannel::bytesFor(children);
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                        static_cast<DWORD>(bytes >> 32), static_cast<DWORD>(bytes),
+                                        name.c_str());
+    if (mapping == NULL) {
+        cerr << "CreateFileMapping failed: " << GetLastError() << endl;
+        return 1;
+    }
+    SharedChannel* channel = static_cast<SharedChannel*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+    if (channel == NULL) {
+        cerr << "MapViewOfFile failed: " << GetLastError() << endl;
+        CloseHandle(mapping);
+        return 1;
+    }
+    channel->rings = children;
+    for (int i = 0; i < children; ++i) {
+        new (channel->ring(i)) ResultRing();
+    }
+
+    char exePath[MAX_PATH];
+    GetModuleFileNameA(NULL, exePath, MAX_PATH);
+    vector<PROCESS_INFORMATION> started;
+    ULONGLONG start = GetTickCount64();
+    for (int c = 0; c < children; ++c) {
+        string cmdLine = "\"" + string(exePath) + "\" child-shared " + name + " "
+                         + to_string(c) + " " + to_string(results);
+        STARTUPINFOA si;
+        PROCESS_INFORMATION pi;
+        ZeroMemory(&si, sizeof(si));
+        si.cb = sizeof(si);
+        ZeroMemory(&pi, sizeof(pi));
+        if (!CreateProcessA(NULL, &cmdLine[0], NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi)) {
+            cerr << "CreateProcess failed: " << GetLastError() << endl;
+            break;
+        }
+        started.push_back(pi);
+    }
+
+    // Drain every ring round-robin until each child is done and empty. A child
+    // that dies early never sets `done`, so its process handle is checked too.
+    vector<uint32_t> expected(started.size(), 0);
+    vector<bool> drained(started.size(), false);
+    long long received = 0;
+    bool valid = true;
+    size_t finished = 0;
+    while (finished < started.size()) {
+        bool progress = false;
+        for (size_t c = 0; c < started.size(); ++c) {
+            if (drained[c]) {
+                continue;
+            }
+            ResultRing* ring = channel->ring(static_cast<int>(c));
+            bool wasDone = ring->done.load(std::memory_order_acquire)
+                           || WaitForSingleObject(started[c].hProcess, 0) == WAIT_OBJECT_0;
+            SharedResult r;
+            while (ring->pop(r)) {
+                valid = valid && r.child == c && r.seq == expected[c]
+                        && r.value == sharedResultValue(r.child, r.seq);
+                ++expected[c];
+                ++received;
+                progress = true;
+            }
+            if (wasDone) {
+                drained[c] = true;
+                ++finished;
+            }
+        }
+        if (!progress) {
+            std::this_thread::yield();
+        }
+    }
+    ULONGLONG elapsed = GetTickCount64() - start;
+
+    for (size_t c = 0; c < started.size(); ++c) {
+        WaitForSingleObject(started[c].hProcess, INFINITE);
+        CloseHandle(started[c].hProcess);
+        CloseHandle(started[c].hThread);
+    }
+    // A child that never started delivered nothing, so the whole run counts
+    bool complete = valid && started.size() == static_cast<size_t>(children)
+                    && received == static_cast<long long>(children) * results;
+    cout << "Received " << received << " results in " << elapsed << " ms, "
+         << (complete ? "all in order and intact" : "INCOMPLETE or CORRUPTED") << endl;
+
+    UnmapViewOfFile(channel);
+    CloseHandle(mapping);
+    return complete ? 0 : 1;
+}
+
 int main(int argc, char* argv[]) {
     // Check if this is the child process
     if (argc > 1 && string(argv[1]) == "child") {
         childProcess();
         return 0;  // Child exits here
     }
+    if (argc > 2 && string(argv[1]) == "child-exit") {
+        return static_cast<int>(strtoul(argv[2], NULL, 10));  // quiet supervised child
+    }
+    if (argc > 4 && string(argv[1]) == "child-shared") {
+        return sharedChild(argv[2], atoi(argv[3]), atoi(argv[4]));
+    }
+    if (argc > 1 && string(argv[1]) == "shared") {
+        int children = argc > 2 ? atoi(argv[2]) : 4;
+        int results = argc > 3 ? atoi(argv[3]) : 1000000;
+        if (children <= 0 || results <= 0) {
+            cerr << "usage: Lab3-1 shared [CHILDREN] [RESULTS_PER_CHILD]" << endl;
+            return 2;
+        }
+        return sharedChannelDemo(children, results);
+    }
+    if (argc > 1 && string(argv[1]) == "supervise") {
+        int total = argc > 2 ? atoi(argv[2]) : 1000;
+        int maxRunning = argc > 3 ? atoi(argv[3]) : 256;
+        if (total <= 0 || maxRunning <= 0) {
+            cerr << "usage: Lab3-1 supervise [CHILDREN] [MAX_RUNNING]" << endl;
+            return 2;
+        }
+        return superviseChildren(total, maxRunning);
+    }
 
     // PARENT PROCESS CODE
     cout << "====================================" << endl;